@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    CoefficientTable.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "CoefficientTable.h"
+#include "Oscillators.h"
+
+CoefficientTableBuilder::CoefficientTableBuilder()
+    : Thread ("Phazer coefficient builder")
+{
+}
+
+CoefficientTableBuilder::~CoefficientTableBuilder()
+{
+    stop();
+}
+
+void CoefficientTableBuilder::start()
+{
+    if (! isThreadRunning())
+        startThread (3);
+}
+
+void CoefficientTableBuilder::stop()
+{
+    stopThread (1000);
+}
+
+void CoefficientTableBuilder::setTargets (double sampleRate, float centerfreq, float width, float depth,
+                                          float rate, int oscType) noexcept
+{
+    // So a rate change doesn't rebuild a table that doesn't depend on it
+    if (! rangeDependsOnRate (oscType))
+        rate = 0.0f;
+
+    if (sampleRate == lastSampleRate && centerfreq == lastCenterfreq && width == lastWidth
+         && depth == lastDepth && rate == lastRate && oscType == lastType)
+        return;
+
+    lastSampleRate = sampleRate;
+    lastCenterfreq = centerfreq;
+    lastWidth = width;
+    lastDepth = depth;
+    lastRate = rate;
+    lastType = oscType;
+
+    targetSampleRate.store (sampleRate, std::memory_order_relaxed);
+    targetCenterfreq.store (centerfreq, std::memory_order_relaxed);
+    targetWidth.store (width, std::memory_order_relaxed);
+    targetDepth.store (depth, std::memory_order_relaxed);
+    targetRate.store (rate, std::memory_order_relaxed);
+    targetType.store (oscType, std::memory_order_relaxed);
+    requestCount.fetch_add (1, std::memory_order_release);
+
+    notify();
+}
+
+const CoefficientTable* CoefficientTableBuilder::acquire() noexcept
+{
+    CoefficientTable* table = published.load();
+
+    // Mark the table as in use, then make sure it wasn't replaced in the meantime.
+    // Once the check passes the builder can no longer pick it for reuse.
+    for (;;)
+    {
+        inUse.store (table);
+        CoefficientTable* check = published.load();
+
+        if (check == table)
+            return table;
+
+        table = check;
+    }
+}
+
+void CoefficientTableBuilder::release() noexcept
+{
+    inUse.store (nullptr);
+}
+
+bool CoefficientTableBuilder::isUpToDate() noexcept
+{
+    const CoefficientTable* table = acquire();
+
+    const bool upToDate = table != nullptr && table->sampleRate == lastSampleRate && table->centerfreq == lastCenterfreq
+                            && table->width == lastWidth && table->depth == lastDepth && table->rate == lastRate
+                            && table->oscType == lastType;
+
+    release();
+    return upToDate;
+}
+
+float CoefficientTableBuilder::getLfoRange (int oscType, float rate)
+{
+    switch (oscType)
+    {
+        // Started from (0.1, 0.1), a steady sine swings 0.1 * sqrt (1 + w^2), w = 2 pi rate.
+        // Half as much again for the swings a rate change leaves behind.
+        case Oscillators::Sine:
+        {
+            const float w = MathConstants<float>::twoPi * rate;
+            return 1.5f * 0.1f * std::sqrt (1.0f + w * w);
+        }
+
+        case Oscillators::Triangle:
+        case Oscillators::Square:
+        case Oscillators::Saw:
+        case Oscillators::AASquare:
+        case Oscillators::AASaw:     return 1.5f;
+        case Oscillators::Vanderpol: return 16.0f;
+        case Oscillators::Duffing:
+        case Oscillators::Lorenz:    return 32.0f;
+        case Oscillators::Chua:      return 48.0f;      // falls through into the Lorenz step, and swings wider
+        default:                     return 8.0f;
+    }
+}
+
+bool CoefficientTableBuilder::rangeDependsOnRate (int oscType)
+{
+    return oscType == Oscillators::Sine;
+}
+
+CoefficientTable* CoefficientTableBuilder::findFreeTable()
+{
+    CoefficientTable* current = published.load();
+    CoefficientTable* reading = inUse.load();
+
+    for (auto& t : tables)
+        if (&t != current && &t != reading)
+            return &t;
+
+    jassertfalse;   // there are three tables and at most two can be taken
+    return nullptr;
+}
+
+void CoefficientTableBuilder::build (CoefficientTable& table, double sampleRate, float centerfreq,
+                                     float width, float depth, float rate, int oscType)
+{
+    const double Omega = 2.0 * double_Pi / sampleRate;
+    const float BW = centerfreq/3 * width;
+    const float range = getLfoRange (oscType, rate);
+
+    for (int i = 0; i <= CoefficientTable::tableSize; ++i)
+    {
+        const float lfo = -range + 2.0f * range * i / (float) CoefficientTable::tableSize;
+        table.Re[i] = (float) (-2.0*depth * cos(Omega*(centerfreq + BW*lfo)));
+    }
+
+    table.z2 = depth*depth;
+    table.lfoRange = range;
+    table.indexScale = CoefficientTable::tableSize / (2.0f * range);
+    table.sampleRate = sampleRate;
+    table.centerfreq = centerfreq;
+    table.width = width;
+    table.depth = depth;
+    table.rate = rate;
+    table.oscType = oscType;
+}
+
+void CoefficientTableBuilder::run()
+{
+    while (! threadShouldExit())
+    {
+        const uint32 requested = requestCount.load (std::memory_order_acquire);
+
+        if (requested != builtCount)
+        {
+            const double sampleRate = targetSampleRate.load (std::memory_order_relaxed);
+
+            if (sampleRate > 0.0)
+            {
+                if (CoefficientTable* table = findFreeTable())
+                {
+                    build (*table, sampleRate,
+                           targetCenterfreq.load (std::memory_order_relaxed),
+                           targetWidth.load (std::memory_order_relaxed),
+                           targetDepth.load (std::memory_order_relaxed),
+                           targetRate.load (std::memory_order_relaxed),
+                           targetType.load (std::memory_order_relaxed));
+
+                    published.store (table);
+                }
+            }
+
+            // If the targets moved while building, the count has changed again
+            // and the next pass picks that up
+            builtCount = requested;
+            continue;
+        }
+
+        // Woken by setTargets(), or by stop()
+        wait (-1);
+    }
+}
@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+    CoefficientTable.h
+    Author:  eric carmi
+
+    Precomputed allpass coefficient curves.
+
+    Every allpass stage uses the same pair of coefficients, Re and z2, which
+    only depend on centerfreq, width, depth and the current LFO value:
+
+        Re = -2 * depth * cos(Omega * (centerfreq + BW * lfo))
+        z2 = depth * depth
+
+    The builder runs on its own thread and samples Re over the output range of
+    the selected oscillator whenever those parameters change. It sleeps until
+    the audio thread sets new targets. Finished tables
+    are published with an atomic pointer swap; the audio thread marks the table
+    it is reading so the builder never overwrites it (deferred reclamation with
+    a single hazard pointer). With three tables there is always one free.
+
+  ==============================================================================
+*/
+
+#ifndef COEFFICIENTTABLE_H_INCLUDED
+#define COEFFICIENTTABLE_H_INCLUDED
+
+#include "DspHeader.h"
+#include <atomic>
+
+struct CoefficientTable
+{
+    enum { tableSize = 1024 };
+
+    // False for LFO values the table doesn't reach, which need the exact path
+    inline bool covers (float lfo) const noexcept   { return std::abs (lfo) <= lfoRange; }
+
+    // Linear interpolation between the two nearest entries.
+    // LFO values outside of the table range are clamped to its edges.
+    inline float getRe (float lfo) const noexcept
+    {
+        const float pos = jlimit (0.0f, (float) tableSize, (lfo + lfoRange) * indexScale);
+        const int i = jmin ((int) pos, (int) tableSize - 1);
+        const float frac = pos - (float) i;
+
+        return Re[i] + frac * (Re[i + 1] - Re[i]);
+    }
+
+    float Re[tableSize + 1];
+    float z2;
+
+    float lfoRange;
+    float indexScale;
+
+    // The parameters this table was built for
+    double sampleRate;
+    float centerfreq, width, depth, rate;
+    int oscType;
+};
+
+//==============================================================================
+class CoefficientTableBuilder  : private Thread
+{
+public:
+    CoefficientTableBuilder();
+    ~CoefficientTableBuilder();
+
+    void start();
+    void stop();
+    bool isRunning() const      { return isThreadRunning(); }
+
+    // Called from the audio thread at the start of each block. Only a few
+    // comparisons, plus some relaxed stores and waking the builder when
+    // something changed.
+    void setTargets (double sampleRate, float centerfreq, float width, float depth, float rate, int oscType) noexcept;
+
+    // Audio thread: the returned table stays valid until release() is called,
+    // returns nullptr if nothing has been published yet
+    const CoefficientTable* acquire() noexcept;
+    void release() noexcept;
+
+    // Audio thread: true once the table for the last targets has been published
+    bool isUpToDate() noexcept;
+
+    // Largest LFO value the table needs to cover for an oscillator type. Only
+    // the sine's amplitude depends on the rate, see rangeDependsOnRate().
+    static float getLfoRange (int oscType, float rate);
+    static bool rangeDependsOnRate (int oscType);
+
+private:
+    void run() override;
+    void build (CoefficientTable& table, double sampleRate, float centerfreq, float width, float depth,
+                float rate, int oscType);
+    CoefficientTable* findFreeTable();
+
+    CoefficientTable tables[3];
+    std::atomic<CoefficientTable*> published { nullptr };
+    std::atomic<CoefficientTable*> inUse { nullptr };
+
+    // Written by the audio thread, read by the builder
+    std::atomic<double> targetSampleRate { 0.0 };
+    std::atomic<float> targetCenterfreq { 0.0f }, targetWidth { 0.0f }, targetDepth { 0.0f }, targetRate { 0.0f };
+    std::atomic<int> targetType { 0 };
+    std::atomic<uint32> requestCount { 0 };
+
+    // Audio thread copies, used to skip the stores when nothing changed
+    double lastSampleRate = 0.0;
+    float lastCenterfreq = 0.0f, lastWidth = 0.0f, lastDepth = 0.0f, lastRate = 0.0f;
+    int lastType = 0;
+
+    uint32 builtCount = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoefficientTableBuilder)
+};
+
+#endif  // COEFFICIENTTABLE_H_INCLUDED
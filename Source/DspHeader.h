@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    DspHeader.h
+    Author:  eric carmi
+
+    The JUCE modules the DSP code needs. Unlike JuceHeader.h this leaves out
+    the GUI and plugin client modules, so the engine can also be built into
+    command line tools that don't link against them.
+
+  ==============================================================================
+*/
+
+#ifndef DSPHEADER_H_INCLUDED
+#define DSPHEADER_H_INCLUDED
+
+#include "../JuceLibraryCode/AppConfig.h"
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#if ! DONT_SET_USING_JUCE_NAMESPACE
+ using namespace juce;
+#endif
+
+#include <new>
+
+//==============================================================================
+// Before C++17 new only aligns to 16 bytes, whatever the class asks for. A
+// class holding an over-aligned member, like PhazerEngine, that is created
+// with new puts this in its declaration to get the alignment it needs.
+#if JUCE_WINDOWS
+ #define PHAZER_ALIGNED_MALLOC(size, alignment)     _aligned_malloc (size, alignment)
+ #define PHAZER_ALIGNED_FREE(p)                     _aligned_free (p)
+#else
+ #define PHAZER_ALIGNED_MALLOC(size, alignment)     phazerPosixMemalign (size, alignment)
+ #define PHAZER_ALIGNED_FREE(p)                     std::free (p)
+
+ inline void* phazerPosixMemalign (size_t size, size_t alignment) noexcept
+ {
+     void* p = nullptr;
+     return posix_memalign (&p, alignment, size) == 0 ? p : nullptr;
+ }
+#endif
+
+#define PHAZER_DECLARE_ALIGNED_NEW(className) \
+    static void* operator new (size_t size) \
+    { \
+        if (void* p = PHAZER_ALIGNED_MALLOC (size, alignof (className))) \
+            return p; \
+        throw std::bad_alloc(); \
+    } \
+    static void operator delete (void* p) noexcept     { PHAZER_ALIGNED_FREE (p); }
+
+#endif  // DSPHEADER_H_INCLUDED
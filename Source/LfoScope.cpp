@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    LfoScope.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "LfoScope.h"
+#include "Oscillators.h"
+
+LfoScope::LfoScope()
+{
+    setOpaque (true);
+    setInterceptsMouseClicks (false, false);
+}
+
+LfoScope::~LfoScope()
+{
+}
+
+void LfoScope::setOscillatorType (int type)
+{
+    // Lorenz shows its butterfly from the side
+    useZForY = type == Oscillators::Lorenz;
+    hasRanges = false;
+
+    clearImages();
+    repaint();
+}
+
+void LfoScope::visibilityChanged()
+{
+    resized();
+}
+
+void LfoScope::resized()
+{
+    // Hidden, which it mostly is, it holds no images
+    if (! isVisible())
+    {
+        attractorImage = Image();
+        traceImage = Image();
+        return;
+    }
+
+    const int traceHeight = getHeight() / 3;
+
+    attractorImage = Image (Image::ARGB, jmax (1, getWidth()), jmax (1, getHeight() - traceHeight), true);
+    traceImage = Image (Image::RGB, jmax (1, getWidth()), jmax (1, traceHeight), true);
+
+    clearImages();
+}
+
+void LfoScope::clearImages()
+{
+    hasLastPoint = false;
+    traceColumn = 0;
+    pointsInColumn = 0;
+
+    if (attractorImage.isNull())
+        return;
+
+    attractorImage.clear (attractorImage.getBounds());
+
+    Graphics g (traceImage);
+    g.fillAll (Colours::black);
+}
+
+bool LfoScope::expandRanges (float x, float y)
+{
+    if (hasRanges && xRange.contains (x) && yRange.contains (y))
+        return false;
+
+    // A quarter of the length spare on either side, so growing soon stops
+    const auto grow = [] (Range<float> r)
+    {
+        const float margin = jmax (0.25f * r.getLength(), 1.0e-3f);
+        return Range<float> (r.getStart() - margin, r.getEnd() + margin);
+    };
+
+    xRange = grow (hasRanges ? xRange.getUnionWith (x) : Range<float> (x, x));
+    yRange = grow (hasRanges ? yRange.getUnionWith (y) : Range<float> (y, y));
+    hasRanges = true;
+    return true;
+}
+
+Point<float> LfoScope::toAttractor (float x, float y) const noexcept
+{
+    return { jmap (x, xRange.getStart(), xRange.getEnd(), 0.0f, (float) attractorImage.getWidth()),
+             jmap (y, yRange.getStart(), yRange.getEnd(), (float) attractorImage.getHeight(), 0.0f) };
+}
+
+float LfoScope::toTrace (float x) const noexcept
+{
+    return jmap (x, xRange.getStart(), xRange.getEnd(), (float) traceImage.getHeight() - 1.0f, 0.0f);
+}
+
+bool LfoScope::update (ScopeFeed& feed)
+{
+    ScopeFeed::Point points[256];
+    int numRead;
+    bool anyRead = false;
+
+    while ((numRead = feed.read (points, numElementsInArray (points))) > 0)
+    {
+        // Not laid out yet, there's nothing to draw into
+        if (attractorImage.isNull())
+            continue;
+
+        bool grew = false;
+
+        for (int i = 0; i < numRead; ++i)
+        {
+            const float y = useZForY ? points[i].z : points[i].y;
+
+            if (std::isfinite (points[i].x) && std::isfinite (y))
+                grew |= expandRanges (points[i].x, y);
+        }
+
+        if (grew)
+            clearImages();
+        else if (! anyRead)
+            attractorImage.multiplyAllAlphas (fadePerUpdate);
+
+        anyRead = true;
+
+        Graphics attractor (attractorImage);
+        Graphics trace (traceImage);
+        attractor.setColour (Colours::cyan);
+
+        for (int i = 0; i < numRead; ++i)
+        {
+            const float x = points[i].x;
+            const float y = useZForY ? points[i].z : points[i].y;
+
+            if (! (std::isfinite (x) && std::isfinite (y)))
+                continue;
+
+            const Point<float> p (toAttractor (x, y));
+
+            if (hasLastPoint)
+                attractor.drawLine (lastAttractorPoint.x, lastAttractorPoint.y, p.x, p.y, 1.0f);
+
+            lastAttractorPoint = p;
+            hasLastPoint = true;
+
+            addToTrace (trace, x);
+        }
+    }
+
+    if (anyRead)
+        repaint();
+
+    return anyRead;
+}
+
+void LfoScope::addToTrace (Graphics& g, float x)
+{
+    columnMin = pointsInColumn == 0 ? x : jmin (columnMin, x);
+    columnMax = pointsInColumn == 0 ? x : jmax (columnMax, x);
+
+    if (++pointsInColumn < pointsPerColumn)
+        return;
+
+    pointsInColumn = 0;
+
+    // Joined to the column before, so fast swings stay one line
+    const float top = jmin (toTrace (columnMax), lastTraceY);
+    const float bottom = jmax (toTrace (columnMin), lastTraceY);
+    lastTraceY = toTrace (x);
+
+    g.setColour (Colours::cyan);
+    g.drawVerticalLine (traceColumn, top, jmax (bottom, top + 1.0f));
+
+    const int width = traceImage.getWidth();
+    g.setColour (Colours::black);
+
+    for (int i = 1; i <= blankColumns; ++i)
+        g.fillRect ((traceColumn + i) % width, 0, 1, traceImage.getHeight());
+
+    traceColumn = (traceColumn + 1) % width;
+}
+
+void LfoScope::paint (Graphics& g)
+{
+    g.fillAll (Colours::black);
+    g.drawImageAt (attractorImage, 0, 0);
+    g.drawImageAt (traceImage, 0, attractorImage.getHeight());
+
+    g.setColour (Colours::darkgrey);
+    g.drawHorizontalLine (attractorImage.getHeight(), 0.0f, (float) getWidth());
+}
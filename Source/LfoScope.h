@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    LfoScope.h
+    Author:  eric carmi
+
+    A scope for the chaotic oscillators: a 2D projection of the attractor
+    above a sweeping trace of the LFO, osc[0], as it drives the notches.
+
+    Both are kept in images that only have the new points drawn into them.
+    The attractor fades a little on every update that brings points, so older
+    orbits dim away, and the trace is swept across like an oscilloscope's,
+    one pixel column per pointsPerColumn points with the next few columns
+    blanked ahead of it. Painting is then just the two images.
+
+    The axes grow to fit the points they've seen since the oscillator was
+    chosen. When one has to grow, the images start again. The images only
+    exist while the scope is visible.
+
+  ==============================================================================
+*/
+
+#ifndef LFOSCOPE_H_INCLUDED
+#define LFOSCOPE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ScopeFeed.h"
+
+class LfoScope  : public Component
+{
+public:
+    LfoScope();
+    ~LfoScope();
+
+    // Starts again for an oscillator type, and picks the projection that shows it best
+    void setOscillatorType (int type);
+
+    // Draws whatever the feed has, returns true if that was anything
+    bool update (ScopeFeed& feed);
+
+    void paint (Graphics& g) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    void clearImages();
+    bool expandRanges (float x, float y);
+    Point<float> toAttractor (float x, float y) const noexcept;
+    float toTrace (float x) const noexcept;
+    void addToTrace (Graphics& g, float x);
+
+    enum
+    {
+        pointsPerColumn = 20,   // at ScopeFeed::pointsPerSecond, 50 columns a second
+        blankColumns = 4
+    };
+
+    static constexpr float fadePerUpdate = 0.96f;
+
+    bool useZForY = false;
+    Range<float> xRange, yRange;
+    bool hasRanges = false;
+
+    Image attractorImage, traceImage;
+    Point<float> lastAttractorPoint;
+    bool hasLastPoint = false;
+
+    int traceColumn = 0, pointsInColumn = 0;
+    float columnMin = 0.0f, columnMax = 0.0f, lastTraceY = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LfoScope)
+};
+
+#endif  // LFOSCOPE_H_INCLUDED
@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    LoadMeter.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "LoadMeter.h"
+
+static const double secondsPerHalf = 5.0;
+static const double smoothingSeconds = 0.5;     // for the recent load
+
+LoadMeter::LoadMeter()
+{
+    clear (halves[0]);
+    clear (halves[1]);
+}
+
+void LoadMeter::clear (Half& half) noexcept
+{
+    for (auto& c : half.counts)
+        c.store (0, std::memory_order_relaxed);
+
+    half.peak.store (0.0f, std::memory_order_relaxed);
+}
+
+void LoadMeter::prepare (double newSampleRate)
+{
+    sampleRate.store (newSampleRate, std::memory_order_relaxed);
+    ticksPerSample = (double) Time::getHighResolutionTicksPerSecond() / newSampleRate;
+    samplesPerHalf = (int64) (secondsPerHalf * newSampleRate);
+    smoothingSamples = smoothingSeconds * newSampleRate;
+    samplesInHalf = 0;
+
+    clear (halves[0]);
+    clear (halves[1]);
+    recentLoad.store (0.0f, std::memory_order_relaxed);
+}
+
+void LoadMeter::addBlock (int64 elapsedTicks, int numSamples) noexcept
+{
+    if (numSamples <= 0 || ticksPerSample <= 0.0)
+        return;
+
+    const float load = (float) ((double) elapsedTicks / (ticksPerSample * numSamples));
+
+    Half& half = halves[currentHalf.load (std::memory_order_relaxed)];
+    std::atomic<uint32>& bucket = half.counts[jlimit (0, (int) numBuckets - 1, (int) (load * bucketsPerUnit))];
+
+    // Only this thread writes, so no read-modify-write is needed
+    bucket.store (bucket.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    numBlocks.store (numBlocks.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (load > half.peak.load (std::memory_order_relaxed))
+        half.peak.store (load, std::memory_order_relaxed);
+
+    if (load > allTimePeak.load (std::memory_order_relaxed))
+        allTimePeak.store (load, std::memory_order_relaxed);
+
+    if (load > 1.0f)
+        numOverruns.store (numOverruns.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // One pole smoothing with the same time constant whatever the block size
+    const float amount = (float) jmin (1.0, numSamples / smoothingSamples);
+    const float recent = recentLoad.load (std::memory_order_relaxed);
+    recentLoad.store (recent + amount * (load - recent), std::memory_order_relaxed);
+
+    samplesInHalf += numSamples;
+
+    if (samplesInHalf >= samplesPerHalf)
+    {
+        const int next = 1 - currentHalf.load (std::memory_order_relaxed);
+        clear (halves[next]);
+        currentHalf.store (next, std::memory_order_relaxed);
+        samplesInHalf = 0;
+    }
+}
+
+float LoadMeter::getPeakLoad() const noexcept
+{
+    return jmax (halves[0].peak.load (std::memory_order_relaxed),
+                 halves[1].peak.load (std::memory_order_relaxed));
+}
+
+void LoadMeter::getHistogram (uint32* counts) const noexcept
+{
+    for (int i = 0; i < numBuckets; ++i)
+        counts[i] = halves[0].counts[i].load (std::memory_order_relaxed)
+                      + halves[1].counts[i].load (std::memory_order_relaxed);
+}
+
+void LoadMeter::reset() noexcept
+{
+    allTimePeak.store (0.0f, std::memory_order_relaxed);
+    numOverruns.store (0, std::memory_order_relaxed);
+    numBlocks.store (0, std::memory_order_relaxed);
+}
+
+String LoadMeter::getReport() const
+{
+    uint32 counts[numBuckets];
+    getHistogram (counts);
+
+    uint32 largest = 1;
+    for (auto c : counts)
+        largest = jmax (largest, c);
+
+    String report;
+    report << "Phazer load at " << String (sampleRate.load (std::memory_order_relaxed), 0) << " Hz: recent "
+           << String (100.0f * getRecentLoad(), 1) << "%, peak " << String (100.0f * getPeakLoad(), 1)
+           << "% over the last " << String ((int) secondsPerHalf) << "-" << String ((int) (2 * secondsPerHalf)) << " s\n"
+           << "all time peak " << String (100.0f * getAllTimePeakLoad(), 1) << "%, "
+           << String (getNumOverruns()) << " of " << String (getNumBlocks()) << " blocks over budget\n";
+
+    for (int i = 0; i < numBuckets; ++i)
+    {
+        if (counts[i] == 0)
+            continue;
+
+        const String range (i == numBuckets - 1 ? String (100 * i / bucketsPerUnit) + "%+"
+                                                : String (100 * i / bucketsPerUnit) + "-" + String (100 * (i + 1) / bucketsPerUnit) + "%");
+
+        report << range.paddedRight (' ', 10)
+               << String::repeatedString ("#", jmax (1, (int) (40 * (uint64) counts[i] / largest))).paddedRight (' ', 41)
+               << String (counts[i]) << "\n";
+    }
+
+    return report;
+}
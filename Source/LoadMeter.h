@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    LoadMeter.h
+    Author:  eric carmi
+
+    How much of its real-time budget each processBlock call uses.
+
+    The load of a block is the time processBlock took divided by the block's
+    duration, numSamples / sampleRate, so 1.0 means the block only just made
+    its deadline. The processor measures every call with the high resolution
+    tick counter, which is monotonic and costs a few tens of nanoseconds.
+
+    Loads go into a histogram of 5% buckets and a peak, both rolling over the
+    last 5 to 10 seconds of audio: there are two halves, the audio thread
+    writes one of them and clears the other when it takes it over. The all
+    time peak and the number of blocks over budget are kept until reset().
+
+    The audio thread is the only writer, so everything is relaxed atomic
+    stores and the meter can be read from any thread without locks.
+
+  ==============================================================================
+*/
+
+#ifndef LOADMETER_H_INCLUDED
+#define LOADMETER_H_INCLUDED
+
+#include "DspHeader.h"
+#include <atomic>
+
+class LoadMeter
+{
+public:
+    enum
+    {
+        numBuckets = 32,        // 5% each, the last one takes everything from 155% up
+        bucketsPerUnit = 20
+    };
+
+    LoadMeter();
+
+    void prepare (double sampleRate);
+
+    // Audio thread, once per processBlock call
+    void addBlock (int64 elapsedTicks, int numSamples) noexcept;
+
+    // Any thread
+    float getRecentLoad() const noexcept        { return recentLoad.load (std::memory_order_relaxed); }
+    float getPeakLoad() const noexcept;         // over the rolling window
+    float getAllTimePeakLoad() const noexcept   { return allTimePeak.load (std::memory_order_relaxed); }
+    uint32 getNumOverruns() const noexcept      { return numOverruns.load (std::memory_order_relaxed); }
+    uint32 getNumBlocks() const noexcept        { return numBlocks.load (std::memory_order_relaxed); }
+
+    // Block counts per bucket over the rolling window
+    void getHistogram (uint32* counts) const noexcept;
+
+    // Clears the all time peak, the overrun count and the block count
+    void reset() noexcept;
+
+    // A few lines of text with everything above, for a bug report
+    String getReport() const;
+
+private:
+    struct Half
+    {
+        std::atomic<uint32> counts[numBuckets];
+        std::atomic<float> peak;
+    };
+
+    static void clear (Half& half) noexcept;
+
+    Half halves[2];
+    std::atomic<int> currentHalf { 0 };
+    int64 samplesInHalf = 0, samplesPerHalf = 0;
+
+    std::atomic<double> sampleRate { 0.0 };
+    double ticksPerSample = 0.0;
+    double smoothingSamples = 0.0;
+
+    std::atomic<float> recentLoad { 0.0f }, allTimePeak { 0.0f };
+    std::atomic<uint32> numOverruns { 0 }, numBlocks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (LoadMeter)
+};
+
+#endif  // LOADMETER_H_INCLUDED
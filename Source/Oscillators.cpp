@@ -27,7 +27,8 @@ Oscillators::Oscillators()
     : delay1(0.1),delay2(0.1),delay3(0.1),
       currentOscillatorType(1),
       oscParam1(5.0),oscParam2(0.1),oscParam3(0.2),
-       oscFreq(440), sampleRate(48000.0), sampleTime(1.0/sampleRate)
+       oscFreq(440), sampleRate(48000.0), sampleTime(1.0/sampleRate),
+      delta(0), delta2(0)
 
 {
 
@@ -158,7 +159,8 @@ void Oscillators::reset()
     delay2 = 0.1;
     delay3 = 0.1;
     oscCounter = 0.0;
-
+    delta = 0;
+    delta2 = 0;
 }
 
 void Oscillators::resetICs(double* ICs)
@@ -202,7 +204,7 @@ void Oscillators::setType(int T)
 
 }
 
-int Oscillators::getType()
+int Oscillators::getType() const
 {
     return currentOscillatorType;
 }
@@ -211,3 +213,39 @@ float Oscillators::chuaNL(float x)
 {
     return -1.0*chua2*x - 0.5*(chua1-chua2)*(fabs(x+1) - fabs(x-1));
 }
+
+void Oscillators::getState(State& state) const
+{
+    state.delay1 = delay1;
+    state.delay2 = delay2;
+    state.delay3 = delay3;
+    state.oscCounter = oscCounter;
+    state.currentOscillatorType = currentOscillatorType;
+    state.oscParam1 = oscParam1;
+    state.oscParam2 = oscParam2;
+    state.oscParam3 = oscParam3;
+    state.oscFreq = oscFreq;
+    state.sampleRate = sampleRate;
+    state.sampleTime = sampleTime;
+    state.duffing1 = duffing1;
+    state.delta = delta;
+    state.delta2 = delta2;
+}
+
+void Oscillators::setState(const State& state)
+{
+    delay1 = state.delay1;
+    delay2 = state.delay2;
+    delay3 = state.delay3;
+    oscCounter = state.oscCounter;
+    currentOscillatorType = state.currentOscillatorType;
+    oscParam1 = state.oscParam1;
+    oscParam2 = state.oscParam2;
+    oscParam3 = state.oscParam3;
+    oscFreq = state.oscFreq;
+    sampleRate = state.sampleRate;
+    sampleTime = state.sampleTime;
+    duffing1 = state.duffing1;
+    delta = state.delta;
+    delta2 = state.delta2;
+}
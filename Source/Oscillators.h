@@ -42,20 +42,38 @@ public:
     float getFrequency();
 
     void setType(int T);
-    int getType();
+    int getType() const;
+
+    // The dynamical systems, which run from initial conditions rather than a phase
+    static bool isDynamical(int type) { return type >= Duffing && type <= Lorenz; }
 
     float chuaNL(float x);
 
+    // Everything that changes while running, see PhazerEngine::State
+    struct State
+    {
+        float delay1, delay2, delay3;
+        double oscCounter;
+        int currentOscillatorType;
+        float oscParam1, oscParam2, oscParam3;
+        float oscFreq, sampleRate, sampleTime;
+        double duffing1;
+        int delta, delta2;
+    };
+
+    void getState(State& state) const;
+    void setState(const State& state);
+
 private:
 
     float delay1, delay2, delay3;
     double oscCounter = 0.0;
     int currentOscillatorType;
-    const double PI = 3.141592653589793;
-    const double TAU = 2.0*PI;
+    static constexpr double PI = 3.141592653589793;
+    static constexpr double TAU = 2.0*PI;
     float oscParam1, oscParam2, oscParam3;
-    const int chuaParam1 = 4;
-    const double chuaParam2 = 100.0/7.0;
+    static constexpr int chuaParam1 = 4;
+    static constexpr double chuaParam2 = 100.0/7.0;
     float oscFreq;
     float sampleRate;
     float sampleTime;
@@ -65,13 +83,13 @@ private:
 
     // Duffing params
     double duffing1 = -1; // alpha < -1, use this as control
-    const int duffing2 = 5;
-    const double duffing3 = 0.02;
+    static constexpr int duffing2 = 5;
+    static constexpr double duffing3 = 0.02;
 
     // Lorenz: sigma, beta, rho
-    const int lorenz1 = 10;
-    const double lorenz2 = 8.0/3.0;
-    const int lorenz3 = 28;
+    static constexpr int lorenz1 = 10;
+    static constexpr double lorenz2 = 8.0/3.0;
+    static constexpr int lorenz3 = 28;
 
     int delta, delta2;
 
@@ -0,0 +1,292 @@
+/*
+  ==============================================================================
+
+    Oversampler.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "Oversampler.h"
+
+namespace
+{
+    // The modified Bessel function of the first kind, order 0, for the Kaiser window
+    double besselI0 (double x)
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; term > 1.0e-15 * sum; ++k)
+        {
+            const double t = x / (2.0 * k);
+            term *= t * t;
+            sum += term;
+        }
+
+        return sum;
+    }
+}
+
+//==============================================================================
+void Oversampler::HalfBand::design (int M, double beta)
+{
+    jassert (M % 2 == 1);
+
+    halfLength = M;
+    taps.malloc ((size_t) M + 1);
+
+    // The odd taps of sin (pi k / 2) / (pi k), windowed, from k = -M to M
+    double sum = 0.0;
+
+    for (int i = 0; i <= M; ++i)
+    {
+        const int k = 2 * i - M;
+        const double x = (double) k / (M + 1);
+        const double window = besselI0 (beta * std::sqrt (1.0 - x * x)) / besselI0 (beta);
+        const double tap = std::sin (0.5 * double_Pi * k) / (double_Pi * k) * window;
+
+        taps[i] = (float) tap;
+        sum += tap;
+    }
+
+    // Unity gain at DC with the centre tap of 0.5
+    for (int i = 0; i <= M; ++i)
+        taps[i] = (float) (taps[i] * 0.5 / sum);
+}
+
+void Oversampler::HalfBand::allocate (int maximumInputLength)
+{
+    const size_t size = (size_t) (halfLength + maximumInputLength);
+
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        upHistory[ch].malloc (size);
+        evenHistory[ch].malloc (size);
+        oddHistory[ch].malloc (size);
+    }
+
+    sums.malloc ((size_t) jmax (1, maximumInputLength));
+    clear();
+}
+
+void Oversampler::HalfBand::clear() noexcept
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        FloatVectorOperations::clear (upHistory[ch], halfLength);
+        FloatVectorOperations::clear (evenHistory[ch], halfLength);
+        FloatVectorOperations::clear (oddHistory[ch], halfLength);
+    }
+}
+
+int Oversampler::HalfBand::getHistory (int channel, float* dest) const noexcept
+{
+    FloatVectorOperations::copy (dest, upHistory[channel], halfLength);
+    FloatVectorOperations::copy (dest + halfLength, evenHistory[channel], halfLength);
+    FloatVectorOperations::copy (dest + 2 * halfLength, oddHistory[channel], halfLength);
+    return 3 * halfLength;
+}
+
+int Oversampler::HalfBand::setHistory (int channel, const float* source) noexcept
+{
+    FloatVectorOperations::copy (upHistory[channel], source, halfLength);
+    FloatVectorOperations::copy (evenHistory[channel], source + halfLength, halfLength);
+    FloatVectorOperations::copy (oddHistory[channel], source + 2 * halfLength, halfLength);
+    return 3 * halfLength;
+}
+
+// sums[n] = the odd taps against history[n] to history[n + halfLength], one
+// tap at a time over the whole block
+inline void Oversampler::HalfBand::dotProducts (const float* history, int numOutput) noexcept
+{
+    FloatVectorOperations::clear (sums, numOutput);
+
+    for (int t = 0; t <= halfLength; ++t)
+        FloatVectorOperations::addWithMultiply (sums, history + t, taps[t], numOutput);
+}
+
+void Oversampler::HalfBand::up (const float* input, float* output, int numInput, int channel) noexcept
+{
+    float* const history = upHistory[channel];
+    FloatVectorOperations::copy (history + halfLength, input, numInput);
+
+    // Zero stuffing halves the level, hence the 2. The odd outputs only see
+    // the centre tap, so they're the input delayed by (M - 1) / 2.
+    dotProducts (history, numInput);
+    const float* const delayed = history + (halfLength + 1) / 2;
+
+    for (int n = 0; n < numInput; ++n)
+    {
+        output[2 * n] = 2.0f * sums[n];
+        output[2 * n + 1] = delayed[n];
+    }
+
+    std::memmove (history, history + numInput, sizeof (float) * (size_t) halfLength);
+}
+
+void Oversampler::HalfBand::down (const float* input, float* output, int numOutput, int channel) noexcept
+{
+    float* const even = evenHistory[channel];
+    float* const odd = oddHistory[channel];
+
+    for (int n = 0; n < numOutput; ++n)
+    {
+        even[halfLength + n] = input[2 * n];
+        odd[halfLength + n] = input[2 * n + 1];
+    }
+
+    // Only every other output is kept, so the odd taps run over the even
+    // inputs and the centre tap picks an odd one from (M + 1) / 2 back
+    dotProducts (even, numOutput);
+    const float* const delayed = odd + (halfLength - 1) / 2;
+
+    for (int n = 0; n < numOutput; ++n)
+        output[n] = sums[n] + 0.5f * delayed[n];
+
+    std::memmove (even, even + numOutput, sizeof (float) * (size_t) halfLength);
+    std::memmove (odd, odd + numOutput, sizeof (float) * (size_t) halfLength);
+}
+
+//==============================================================================
+Oversampler::Oversampler()
+{
+    stages[0].design (halfLength1, 9.0);
+    stages[1].design (halfLength2, 10.0);
+    stages[2].design (halfLength3, 9.5);
+
+    prepare (0);
+}
+
+Oversampler::~Oversampler()
+{
+}
+
+void Oversampler::prepare (int maximumBlockSize)
+{
+    maxBlockSize = maximumBlockSize;
+
+    for (int s = 0; s < maxFactorLog2; ++s)
+    {
+        stages[s].allocate (maxBlockSize << s);
+        rateBuffers[s].setSize (maxChannels, jmax (1, maxBlockSize << (s + 1)));
+    }
+
+    reset();
+}
+
+void Oversampler::setFactorLog2 (int newFactorLog2) noexcept
+{
+    factorLog2 = jlimit (0, (int) maxFactorLog2, newFactorLog2);
+
+    // Each doubling's round trip is M samples at its lower rate
+    int delay = 0;
+
+    for (int s = 0; s < factorLog2; ++s)
+        delay += stages[s].halfLength << (factorLog2 - s);
+
+    numPadding = (getFactor() - delay % getFactor()) % getFactor();
+    latency = (delay + numPadding) >> factorLog2;
+
+    reset();
+}
+
+void Oversampler::reset() noexcept
+{
+    for (auto& stage : stages)
+        stage.clear();
+
+    for (auto& p : padding)
+        FloatVectorOperations::clear (p, maxPadding);
+}
+
+AudioBuffer<float>& Oversampler::upsample (const AudioBuffer<float>& input) noexcept
+{
+    jassert (factorLog2 > 0 && input.getNumSamples() <= maxBlockSize);
+
+    const int numChannels = jmin (input.getNumChannels(), (int) maxChannels);
+    int numSamples = input.getNumSamples();
+
+    for (int s = 0; s < factorLog2; ++s)
+    {
+        AudioBuffer<float>& dest = rateBuffers[s];
+        dest.setSize (numChannels, numSamples * 2, false, false, true);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            stages[s].up (s == 0 ? input.getReadPointer (ch) : rateBuffers[s - 1].getReadPointer (ch),
+                          dest.getWritePointer (ch), numSamples, ch);
+
+        numSamples *= 2;
+    }
+
+    AudioBuffer<float>& top = rateBuffers[factorLog2 - 1];
+    delayTopRate (top, numChannels);
+    return top;
+}
+
+void Oversampler::downsample (AudioBuffer<float>& output) noexcept
+{
+    jassert (factorLog2 > 0 && rateBuffers[factorLog2 - 1].getNumSamples() == output.getNumSamples() << factorLog2);
+
+    const int numChannels = jmin (output.getNumChannels(), (int) maxChannels);
+    int numSamples = output.getNumSamples() << factorLog2;
+
+    for (int s = factorLog2; --s >= 0;)
+    {
+        numSamples /= 2;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            stages[s].down (rateBuffers[s].getReadPointer (ch),
+                            s == 0 ? output.getWritePointer (ch) : rateBuffers[s - 1].getWritePointer (ch),
+                            numSamples, ch);
+    }
+}
+
+void Oversampler::delayTopRate (AudioBuffer<float>& buffer, int numChannels) noexcept
+{
+    const int numSamples = buffer.getNumSamples();
+
+    // Never more padding than samples, they come in whole multiples of the factor
+    if (numPadding == 0 || numSamples == 0)
+        return;
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        float* const data = buffer.getWritePointer (ch);
+        float last[maxPadding];
+
+        FloatVectorOperations::copy (last, data + numSamples - numPadding, numPadding);
+        std::memmove (data + numPadding, data, sizeof (float) * (size_t) (numSamples - numPadding));
+        FloatVectorOperations::copy (data, padding[ch], numPadding);
+        FloatVectorOperations::copy (padding[ch], last, numPadding);
+    }
+}
+
+void Oversampler::getState (State& state) const noexcept
+{
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        float* dest = state.history[ch];
+
+        for (auto& stage : stages)
+            dest += stage.getHistory (ch, dest);
+
+        FloatVectorOperations::copy (dest, padding[ch], maxPadding);
+    }
+
+    state.factorLog2 = factorLog2;
+}
+
+void Oversampler::setState (const State& state) noexcept
+{
+    jassert (state.factorLog2 == factorLog2);      // set the same factor first
+
+    for (int ch = 0; ch < maxChannels; ++ch)
+    {
+        const float* source = state.history[ch];
+
+        for (auto& stage : stages)
+            source += stage.setHistory (ch, source);
+
+        FloatVectorOperations::copy (padding[ch], source, maxPadding);
+    }
+}
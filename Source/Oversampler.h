@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    Oversampler.h
+    Author:  eric carmi
+
+    Runs the engine at 2, 4 or 8 times the host rate, so the modulated
+    cascade doesn't alias when fast LFOs and deep settings push it near the
+    top of the band.
+
+    Each doubling is a half-band lowpass FIR in polyphase form. Every other
+    tap of a half-band filter is zero, apart from the centre one of 0.5, so
+    going up one output of each pair is just a delayed input and the other a
+    dot product with the M + 1 odd taps; coming down is the same dot product
+    over the even input samples plus half a delayed odd one. The filters are
+    Kaiser windowed and designed here. The first doubling does the real work,
+    flat to 20 kHz at 44.1 kHz and 91 dB down from 24.1 kHz with 127 taps. The
+    later ones only have to keep images out of the band the first one passes,
+    so they're much shorter and 4x and 8x cost little more than 2x.
+
+    The dot products go a tap at a time across the whole block with
+    FloatVectorOperations, so they're SIMD on every platform and the cost per
+    host sample is fixed for each factor, whatever the block size.
+
+    The filters are linear phase, so the round trip is a pure delay. Where
+    the stages alone would leave a fraction of a host sample, a short delay
+    at the top rate pads it out, and getLatencySamples() is exact.
+
+    prepare() allocates everything for 8x, so the factor can be changed on
+    the audio thread.
+
+  ==============================================================================
+*/
+
+#ifndef OVERSAMPLER_H_INCLUDED
+#define OVERSAMPLER_H_INCLUDED
+
+#include "DspHeader.h"
+
+class Oversampler
+{
+public:
+    enum
+    {
+        maxFactorLog2 = 3,
+        maxChannels = 2,
+        maxPadding = (1 << maxFactorLog2) - 1,
+
+        // M for each doubling, the filter has 2M + 1 taps of which M + 1 are odd
+        halfLength1 = 63,
+        halfLength2 = 11,
+        halfLength3 = 7,
+
+        // Per channel: M samples of history for upsampling, and for each
+        // phase coming down, for every doubling, then the padding
+        historySize = 3 * (halfLength1 + halfLength2 + halfLength3) + maxPadding
+    };
+
+    Oversampler();
+    ~Oversampler();
+
+    // For blocks of up to maximumBlockSize samples at the host rate, at any factor
+    void prepare (int maximumBlockSize);
+
+    // 0 is off, 1 to 3 are 2x, 4x and 8x. Clears the filters, never allocates.
+    void setFactorLog2 (int newFactorLog2) noexcept;
+    int getFactorLog2() const noexcept          { return factorLog2; }
+    int getFactor() const noexcept              { return 1 << factorLog2; }
+
+    // The round trip delay, in samples at the host rate
+    int getLatencySamples() const noexcept      { return latency; }
+
+    void reset() noexcept;
+
+    // Upsamples a mono or stereo block. The result is valid until the next call.
+    AudioBuffer<float>& upsample (const AudioBuffer<float>& input) noexcept;
+
+    // Brings what upsample() returned, processed in place, back to the host rate
+    void downsample (AudioBuffer<float>& output) noexcept;
+
+    // The filter histories, see PhazerEngine::State
+    struct State
+    {
+        float history[maxChannels][historySize];
+        int32 factorLog2;
+    };
+
+    void getState (State& state) const noexcept;
+    void setState (const State& state) noexcept;
+
+private:
+    struct HalfBand
+    {
+        int halfLength = 0;
+
+        // The odd taps, summing to 0.5. Symmetric, so the order doesn't matter
+        // when they're run against the input oldest first.
+        HeapBlock<float> taps;
+
+        // Each starts with halfLength samples of history, then the block
+        HeapBlock<float> upHistory[maxChannels], evenHistory[maxChannels], oddHistory[maxChannels];
+        HeapBlock<float> sums;
+
+        void design (int M, double beta);
+        void allocate (int maximumInputLength);
+        void clear() noexcept;
+        int getHistory (int channel, float* dest) const noexcept;
+        int setHistory (int channel, const float* source) noexcept;
+
+        void up (const float* input, float* output, int numInput, int channel) noexcept;
+        void down (const float* input, float* output, int numOutput, int channel) noexcept;
+        void dotProducts (const float* history, int numOutput) noexcept;
+    };
+
+    void delayTopRate (AudioBuffer<float>& buffer, int numChannels) noexcept;
+
+    HalfBand stages[maxFactorLog2];
+    AudioBuffer<float> rateBuffers[maxFactorLog2];      // at 2x, 4x and 8x
+    float padding[maxChannels][maxPadding];
+    int numPadding = 0;
+
+    int factorLog2 = 0, latency = 0, maxBlockSize = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampler)
+};
+
+#endif  // OVERSAMPLER_H_INCLUDED
@@ -0,0 +1,490 @@
+/*
+  ==============================================================================
+
+    PhazerEngine.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "PhazerEngine.h"
+
+void PhazerParameters::limit() noexcept
+{
+    rate = jlimit (0.001f, 20.0f, rate);
+    depth = jlimit (0.3f, 0.99f, depth);
+    width = jlimit (0.1f, 0.9f, width);
+    centerfreq = jlimit (100.0f, 4000.0f, centerfreq);
+    mix = jlimit (-1.0f, 1.0f, mix);
+    stages = jlimit (1, 16, stages);
+    oversampling = jlimit (0, (int) Oversampler::maxFactorLog2, oversampling);
+}
+
+//==============================================================================
+PhazerEngine::PhazerEngine()
+{
+    // Created with a plain new, see PHAZER_DECLARE_ALIGNED_NEW
+    jassert (((pointer_sized_int) this & (alignof (PhazerEngine) - 1)) == 0);
+
+    oscillator.setType(Oscillators::Sine);
+}
+
+PhazerEngine::~PhazerEngine()
+{
+}
+
+void PhazerEngine::prepare (double newSampleRate, int maximumBlockSize)
+{
+    hostRate = newSampleRate;
+    crossFadeBuffer.setSize(2, maximumBlockSize);
+    oversampler.prepare(maximumBlockSize);
+
+    LFOangle = 0.0;
+    updateProcessingRate();
+
+    if(useCoefficientTables)
+        coefficientBuilder->start();
+}
+
+// Everything that runs per sample runs at the oversampled rate
+void PhazerEngine::updateProcessingRate()
+{
+    sampRate = hostRate * oversampler.getFactor();
+
+    setRampLength((int) std::floor(smoothingTime * sampRate));
+    oscillator.setSampleRate(sampRate);
+
+    scopeDecimation = jmax(1, roundToInt(sampRate / ScopeFeed::pointsPerSecond));
+    scopeCountdown = 0;
+}
+
+void PhazerEngine::setOversampling (int factorLog2)
+{
+    factorLog2 = jlimit(0, (int) Oversampler::maxFactorLog2, factorLog2);
+
+    if(factorLog2 == oversampler.getFactorLog2())
+        return;
+
+    oversampler.setFactorLog2(factorLog2);
+    updateProcessingRate();
+}
+
+void PhazerEngine::release()
+{
+    if(coefficientBuilder != nullptr)
+        coefficientBuilder->stop();
+}
+
+void PhazerEngine::reset()
+{
+    filterAP1L.reset();
+    filterAP1R.reset();
+    oscillator.setType(oscillator.getType());
+
+    for (auto* sm : { &SMdepth, &SMrate, &SMwidth, &SMcenterfreq, &SMmix, &SMnumstages })
+        sm->setCurrentAndTargetValue(0.0);
+
+    for (auto& o : osc)
+        o = 0.0f;
+
+    LFOangle = 0.0;
+    lastRe = lastZ2 = 0.0;
+    crossFadeFlag = false;
+    resetICflag = false;
+    crossFadeBuffer.clear();
+    oversampler.reset();
+}
+
+void PhazerEngine::getState (State& state) const
+{
+    oscillator.getState(state.oscillator);
+    filterAP1L.getState(state.filterLeft);
+    filterAP1R.getState(state.filterRight);
+
+    state.depth = SMdepth;
+    state.rate = SMrate;
+    state.width = SMwidth;
+    state.centerfreq = SMcenterfreq;
+    state.mix = SMmix;
+    state.numstages = SMnumstages;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        state.osc[i] = osc[i];
+        state.ICs[i] = ICs[i];
+    }
+
+    state.LFOangle = LFOangle;
+    state.sampleRate = sampRate;
+    state.crossFadeFlag = crossFadeFlag;
+    state.resetICflag = resetICflag;
+    oversampler.getState(state.oversampler);
+}
+
+void PhazerEngine::setState (const State& state)
+{
+    jassert (state.sampleRate == sampRate);     // prepare() the engine for the same rate first
+
+    oscillator.setState(state.oscillator);
+    filterAP1L.setState(state.filterLeft);
+    filterAP1R.setState(state.filterRight);
+
+    SMdepth = state.depth;
+    SMrate = state.rate;
+    SMwidth = state.width;
+    SMcenterfreq = state.centerfreq;
+    SMmix = state.mix;
+    SMnumstages = state.numstages;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        osc[i] = state.osc[i];
+        ICs[i] = state.ICs[i];
+    }
+
+    LFOangle = state.LFOangle;
+    crossFadeFlag = state.crossFadeFlag;
+    resetICflag = state.resetICflag;
+    oversampler.setState(state.oversampler);
+}
+
+void PhazerEngine::setCoefficientTablesEnabled (bool shouldBeEnabled)
+{
+    useCoefficientTables = shouldBeEnabled;
+
+    if(shouldBeEnabled)
+    {
+        if(coefficientBuilder == nullptr)
+            coefficientBuilder = new CoefficientTableBuilder();
+
+        coefficientBuilder->start();
+    }
+    else if(coefficientBuilder != nullptr)
+    {
+        coefficientBuilder->stop();
+    }
+}
+
+bool PhazerEngine::startTelemetryLog (const File& file)
+{
+    telemetryLogger = nullptr;
+    telemetryLogger = new TelemetryFileLogger (telemetry, file);
+
+    if (! telemetryLogger->openedOk())
+        telemetryLogger = nullptr;
+
+    return telemetryLogger != nullptr;
+}
+
+void PhazerEngine::stopTelemetryLog()
+{
+    telemetryLogger = nullptr;
+}
+
+size_t PhazerEngine::getHotStateSize() const noexcept
+{
+    return (size_t) (reinterpret_cast<const char*> (&numStages + 1) - reinterpret_cast<const char*> (this));
+}
+
+void PhazerEngine::process (AudioBuffer<float>& buffer, const PhazerParameters& params)
+{
+    PHAZER_TRACE_SCOPE (process);
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+    const int numSamples = buffer.getNumSamples();
+
+    setOversampling(params.oversampling);
+
+    // The filters run with the effect off too, so switching it doesn't move the latency
+    if(oversampler.getFactorLog2() > 0 && numSamples > 0)
+    {
+        AudioBuffer<float>* oversampled;
+
+        {
+            PHAZER_TRACE_SCOPE (oversampling);
+            oversampled = &oversampler.upsample(buffer);
+        }
+
+        if(params.power)
+            mainEffectLoop(*oversampled, params);
+
+        PHAZER_TRACE_SCOPE (oversampling);
+        oversampler.downsample(buffer);
+    }
+    else if(params.power)
+    {
+        mainEffectLoop(buffer, params);
+    }
+
+    if(crossFadeFlag)
+    {
+        PHAZER_TRACE_SCOPE (crossfade);
+
+        // Mix the newly processed buffer with the previous buffer
+        // Old buffer starts with amplitude of 1, decreases to 0; vice versa for new buffer
+        const float del = (double)(1.0/numSamples);
+
+        for(int chan = 0; chan > buffer.getNumChannels(); ++chan)
+        {
+            float* newBuff = buffer.getWritePointer(chan);
+            float* oldBuff = crossFadeBuffer.getWritePointer(chan);
+
+            for(int samp = 0; samp < numSamples; ++samp)
+            {
+                const float outSamp = newBuff[samp]*(samp+del) + oldBuff[samp]*(1-(samp+del));
+                newBuff[samp] = outSamp;
+            }
+        }
+        crossFadeFlag = false;
+    }
+
+    {
+        PHAZER_TRACE_SCOPE (bufferCopy);
+
+        // Keeps the storage from prepare() when the host sends a shorter block
+        crossFadeBuffer.makeCopyOf(buffer, true);
+    }
+
+    TelemetryRecord record;
+    record.blockNumber = blockCounter++;
+    record.events = 0;
+    record.lfo = osc[0];
+    record.notchFreq = centerfreq + centerfreq/3 * width * osc[0];
+    record.allpassRe = (float) lastRe;
+    record.allpassZ2 = (float) lastZ2;
+    record.mix = params.power ? mix : 0.0f;
+    record.stages = numStages;
+    record.blockMicros = (float) (1.0e6 * Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks));
+    record.budgetMicros = (float) (1.0e6 * numSamples / hostRate);
+
+    if (record.blockMicros > record.budgetMicros)
+        record.events |= TelemetryRecord::overBudget;
+    if (! std::isfinite (osc[0]))
+        record.events |= TelemetryRecord::nonFiniteLfo;
+    if (numSamples > 0 && ! std::isfinite (buffer.getSample (0, numSamples - 1)))
+        record.events |= TelemetryRecord::nonFiniteOutput;
+
+    telemetry.push(record);
+}
+
+void PhazerEngine::skip (int numSamples, const PhazerParameters& params)
+{
+    setOversampling(params.oversampling);
+
+    // Same as process(): the LFO only runs while the effect is on
+    if(! params.power)
+        return;
+
+    beginBlock(params);
+
+    const int numControlSamples = numSamples * oversampler.getFactor();
+
+    for(int samp = 0; samp < numControlSamples; ++samp)
+        advanceControls();
+}
+
+void PhazerEngine::processRamp (AudioBuffer<float>& buffer, const PhazerParameters& from, const PhazerParameters& to)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    if(numSamples == 0)
+        return;
+
+    // Switched first, since switching puts the ramp lengths back
+    setOversampling(to.oversampling);
+    setRampLength(numSamples * oversampler.getFactor());
+
+    SMrate.setCurrentAndTargetValue(from.rate);
+    SMdepth.setCurrentAndTargetValue(from.depth);
+    SMwidth.setCurrentAndTargetValue(from.width);
+    SMmix.setCurrentAndTargetValue(from.mix);
+    SMcenterfreq.setCurrentAndTargetValue(from.centerfreq);
+    SMnumstages.setCurrentAndTargetValue(to.stages);
+
+    // process() sets these targets again, which changes nothing
+    process(buffer, to);
+
+    // Every ramp has just reached its target, so this doesn't move anything
+    setRampLength((int) std::floor(smoothingTime * sampRate));
+}
+
+void PhazerEngine::setRampLength (int numSamples)
+{
+    SMmix.reset(numSamples);
+    SMrate.reset(numSamples);
+    SMwidth.reset(numSamples);
+    SMcenterfreq.reset(numSamples);
+    SMdepth.reset(numSamples);
+}
+
+void PhazerEngine::beginBlock (const PhazerParameters& params)
+{
+    Omega = 2.0 * double_Pi / sampRate;
+
+    SMrate.setValue(params.rate);
+    SMdepth.setValue(params.depth);
+    SMwidth.setValue(params.width);
+    SMmix.setValue(params.mix);
+    SMcenterfreq.setValue(params.centerfreq);
+    SMnumstages.setValue(params.stages);
+
+    if(resetICflag)
+    {
+        oscillator.resetICs(ICs);
+        resetICflag = false;
+    }
+}
+
+inline void PhazerEngine::advanceControls()
+{
+    rate = SMrate.getNextValue();
+    depth = SMdepth.getNextValue();
+    width = SMwidth.getNextValue();
+    mix = SMmix.getNextValue();
+    centerfreq = SMcenterfreq.getNextValue();
+
+    // Smoothing number of stages does not help artifacts while changing it quickly.
+    // Might need to do some sort of cross fade buffer
+    numStages = static_cast<int>(SMnumstages.getNextValue());
+
+    LFOdelta = Omega*rate;
+    LFOangle += LFOdelta;
+
+    oscillator.setFrequency(rate);
+    oscillator.getNextSample(osc, 0.0);
+
+    if(--scopeCountdown <= 0)
+    {
+        scopeCountdown = scopeDecimation;
+        scope.push(osc);
+    }
+}
+
+void PhazerEngine::mainEffectLoop (AudioBuffer<float>& buffer, const PhazerParameters& params)
+{
+    const int nums = buffer.getNumSamples();
+    const int chans = buffer.getNumChannels();
+
+    {
+        PHAZER_TRACE_SCOPE (parameterRead);
+        beginBlock(params);
+    }
+
+    // Tables are only used if they were built for the oscillator that is running now
+    const CoefficientTable* table = nullptr;
+    if(useCoefficientTables)
+    {
+        PHAZER_TRACE_SCOPE (coefficients);
+
+        coefficientBuilder->setTargets(sampRate, params.centerfreq, params.width, params.depth, params.rate, oscillator.getType());
+        table = coefficientBuilder->acquire();
+
+        if(table != nullptr && (table->oscType != oscillator.getType() || table->sampleRate != sampRate))
+        {
+            coefficientBuilder->release();
+            table = nullptr;
+        }
+    }
+
+    // Left with the last sample's coefficients for the telemetry
+    double Re = lastRe, z2 = lastZ2;
+
+    if( chans == 2 )
+    {
+
+        float* leftChannel = buffer.getWritePointer (0);
+        float* rightChannel = buffer.getWritePointer (1);
+
+        PHAZER_TRACE_SPLITTER (split);
+
+        for( int samp = 0; samp < nums; samp++)
+        {
+            const float leftin = leftChannel[samp];
+            const float rightin = rightChannel[samp];
+
+            advanceControls();
+            PHAZER_TRACE_SPLIT (split, lfo);
+
+            // Anything the table doesn't reach, like a rate ramp outrunning the rebuild, is computed exactly
+            if(table != nullptr && table->covers(osc[0]))
+            {
+                Re = table->getRe(osc[0]);
+                z2 = table->z2;
+            }
+            else
+            {
+                const float BW = centerfreq/3 * width;
+                Re = -2.0*depth * cos(Omega*(centerfreq + BW*osc[0]));
+                z2 = depth*depth;
+            }
+
+            const IIRCoefficients coefficients (z2, Re, 1.0, 1.0, Re, z2);
+
+            float leftout = leftin;
+            float rightout = rightin;
+
+            filterAP1L.setCoefficients(coefficients);
+            filterAP1R.setCoefficients(coefficients);
+            PHAZER_TRACE_SPLIT (split, coefficients);
+
+            for(int stage = 0; stage < 4*numStages; ++stage)
+            {
+                leftout = filterAP1L.processSingleSampleRaw(leftout);
+                rightout = filterAP1R.processSingleSampleRaw(rightout);
+            }
+
+            leftChannel[samp]  = leftin + leftout * mix;
+            rightChannel[samp] = rightin  + rightout * mix;
+            PHAZER_TRACE_SPLIT (split, cascade);
+        }
+    }
+
+    if( chans == 1 )
+    {
+        float* leftChannel = buffer.getWritePointer (0);
+
+        PHAZER_TRACE_SPLITTER (split);
+
+        for( int samp = 0; samp < nums; samp++)
+        {
+
+            const float leftin = leftChannel[samp];
+
+            advanceControls();
+            PHAZER_TRACE_SPLIT (split, lfo);
+
+            // Anything the table doesn't reach, like a rate ramp outrunning the rebuild, is computed exactly
+            if(table != nullptr && table->covers(osc[0]))
+            {
+                Re = table->getRe(osc[0]);
+                z2 = table->z2;
+            }
+            else
+            {
+                const float BW = centerfreq/3 * width;
+                Re = -2.0*depth * cos(Omega*(centerfreq + BW*osc[0]));
+                z2 = depth*depth;
+            }
+
+            const IIRCoefficients coefficients (z2, Re, 1.0, 1.0, Re, z2);
+
+            float leftout = leftin;
+            filterAP1L.setCoefficients(coefficients);
+            PHAZER_TRACE_SPLIT (split, coefficients);
+
+            for(int stage = 0; stage < 4*numStages; ++stage)
+            {
+                leftout = filterAP1L.processSingleSampleRaw(leftout);
+            }
+
+            leftChannel[samp]  = leftin  + leftout * mix;
+            PHAZER_TRACE_SPLIT (split, cascade);
+        }
+    }
+
+    if(table != nullptr)
+        coefficientBuilder->release();
+
+    lastRe = Re;
+    lastZ2 = z2;
+}
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    PhazerEngine.h
+    Author:  eric carmi
+
+    The phaser itself: LFO, allpass cascade, smoothing and the power crossfade.
+
+    The plugin processor owns one of these and feeds it its parameter values
+    every block. It has no dependency on the plugin wrapper or the GUI, so the
+    offline tools drive it directly.
+
+  ==============================================================================
+*/
+
+#ifndef PHAZERENGINE_H_INCLUDED
+#define PHAZERENGINE_H_INCLUDED
+
+#include "DspHeader.h"
+#include "Oscillators.h"
+#include "CoefficientTable.h"
+#include "Telemetry.h"
+#include "ScopeFeed.h"
+#include "Oversampler.h"
+#include "TraceEvents.h"
+
+// Parameter values for one block, in the same units and ranges as the plugin parameters
+struct PhazerParameters
+{
+    float rate = 0.5f;
+    float depth = 0.8f;
+    float width = 0.5f;
+    float centerfreq = 999.977f;
+    float mix = 0.0f;
+    int stages = 4;
+    bool power = true;
+    int oversampling = 0;       // log2 of the factor, 0 to Oversampler::maxFactorLog2
+
+    // Clamps every value to the range of its plugin parameter
+    void limit() noexcept;
+};
+
+//==============================================================================
+// An IIRFilter whose two state variables can be saved and restored
+class AllpassFilter  : public IIRFilter
+{
+public:
+    void getState (float* state) const noexcept     { state[0] = v1; state[1] = v2; }
+    void setState (const float* state) noexcept     { v1 = state[0]; v2 = state[1]; }
+};
+
+//==============================================================================
+// Over-aligned, so a class that holds one and is created with new needs
+// PHAZER_DECLARE_ALIGNED_NEW, see DspHeader.h
+class alignas (64) PhazerEngine
+{
+public:
+    PhazerEngine();
+    ~PhazerEngine();
+
+    PHAZER_DECLARE_ALIGNED_NEW (PhazerEngine)
+
+    void prepare (double sampleRate, int maximumBlockSize);
+    void release();
+
+    // Puts the filters, oscillator and smoothers back where a new engine starts,
+    // so one engine can render several independent files
+    void reset();
+
+    // Processes a mono or stereo buffer in place
+    void process (AudioBuffer<float>& buffer, const PhazerParameters& params);
+
+    // Advances the LFO and smoothers exactly as process() would for a block of
+    // this length, without touching any audio or the filters. Much cheaper, so a
+    // pre-pass can find the LFO state anywhere in a file.
+    void skip (int numSamples, const PhazerParameters& params);
+
+    // For sample-accurate automation. Instead of the usual smoothing, every
+    // value moves in a straight line from `from` to `to` across the block:
+    // sample n gets from + (n + 1) * (to - from) / numSamples, so the last
+    // sample gets exactly `to`. Stages jump straight to to.stages. The next
+    // process() call smooths as usual again. Oversampled, n counts the
+    // samples at the oversampled rate.
+    void processRamp (AudioBuffer<float>& buffer, const PhazerParameters& from, const PhazerParameters& to);
+
+    // Everything the output depends on, as plain data. A state taken from one
+    // engine can be loaded into another prepared for the same sample rate, which
+    // then carries on sample for sample where the first one was.
+    struct State
+    {
+        Oscillators::State oscillator;
+        float filterLeft[2], filterRight[2];
+        LinearSmoothedValue<double> depth, rate, width, centerfreq, mix, numstages;
+        float osc[3];
+        double ICs[3];
+        double LFOangle;
+        double sampleRate;
+        bool crossFadeFlag, resetICflag;
+        Oversampler::State oversampler;
+    };
+
+    void getState (State& state) const;
+    void setState (const State& state);
+
+    // The rate the cascade runs at, the host's times the oversampling factor
+    double getSampleRate() const                { return sampRate; }
+
+    // Switches the oversampling factor, which process() also does when
+    // params.oversampling changes. Clears the oversampling filters but never
+    // allocates, so it's safe on the audio thread.
+    void setOversampling (int factorLog2);
+    int getOversampling() const noexcept        { return oversampler.getFactorLog2(); }
+
+    // Host rate samples of delay the oversampling filters add, for setLatencySamples()
+    int getLatencySamples() const noexcept      { return oversampler.getLatencySamples(); }
+
+    // When enabled, Re and z2 are looked up from tables built on a separate thread
+    // instead of being computed per sample. Centerfreq, width and depth then follow
+    // the builder's rebuild rate rather than the per-sample smoothers.
+    // The builder and its tables are only allocated once this is first enabled,
+    // so call it while the engine isn't processing.
+    void setCoefficientTablesEnabled (bool shouldBeEnabled);
+    bool areCoefficientTablesEnabled() const    { return useCoefficientTables; }
+
+    // True once the tables for the parameters of the last block are ready, so the
+    // next block really uses them. Call it from the thread that calls process().
+    bool areCoefficientTablesReady()            { return useCoefficientTables && coefficientBuilder->isUpToDate(); }
+
+    bool startTelemetryLog (const File& file);
+    void stopTelemetryLog();
+
+    // Bytes from the start of the engine to the end of the per-sample state
+    size_t getHotStateSize() const noexcept;
+
+private:
+    //==============================================================================
+    void mainEffectLoop (AudioBuffer<float>& buffer, const PhazerParameters& params);
+    void beginBlock (const PhazerParameters& params);
+    void advanceControls();
+    void setRampLength (int numSamples);
+    void updateProcessingRate();
+
+    static constexpr double smoothingTime = 0.1;     // seconds
+
+    //==============================================================================
+    // The members are in the order the audio thread needs them. The engine is
+    // aligned to a cache line and starts with everything the per-sample loop
+    // reads and writes, so that's a few whole lines (getHotStateSize()); then
+    // the values read once per block, then what it hardly touches. The
+    // per-sample temporaries are locals of mainEffectLoop().
+public:
+    Oscillators oscillator;
+
+private:
+    AllpassFilter filterAP1L, filterAP1R;
+    LinearSmoothedValue<double> SMdepth, SMrate, SMwidth, SMcenterfreq, SMmix, SMnumstages;
+    double Omega = 0.0, LFOangle = 0.0, LFOdelta = 0.0;
+    float rate = 0, depth = 0, width = 0, mix = 0, centerfreq = 0;
+    float osc[3] = {0.0f, 0.0f, 0.0f};
+    int scopeCountdown = 0, scopeDecimation = 1;
+    int numStages = 0;
+
+    //==============================================================================
+public:
+    double ICs[3] = {0.0f, 0.0f, 0.0f};
+    bool resetICflag = false;
+    bool crossFadeFlag = false;
+
+private:
+    bool useCoefficientTables = false;
+    uint32 blockCounter = 0;
+    double sampRate = 44100.0;                  // the processing rate, oversampled
+    double hostRate = 44100.0;
+    double lastRe = 0.0, lastZ2 = 0.0;      // coefficients of the last sample, for telemetry
+
+    //==============================================================================
+public:
+    // One record per block: LFO, notch frequency, cascade coefficients, block time
+    // and watchdog events.
+    // Readable from any thread, see TelemetryStream.
+    TelemetryStream telemetry;
+
+    // The LFO decimated for the editor's scope, read by one thread at a time
+    ScopeFeed scope;
+
+private:
+    // Crossfade buffer is used to smooth transitions between switching the effect on and off
+    // When power is switched, the effect will slowly come in
+    // This requires copying every buffer into the crossfade buffer until it is needed
+    AudioBuffer<float> crossFadeBuffer;
+
+    Oversampler oversampler;
+    ScopedPointer<CoefficientTableBuilder> coefficientBuilder;
+    ScopedPointer<TelemetryFileLogger> telemetryLogger;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhazerEngine)
+};
+
+#endif  // PHAZERENGINE_H_INCLUDED
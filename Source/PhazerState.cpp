@@ -0,0 +1,171 @@
+/*
+  ==============================================================================
+
+    PhazerState.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "PhazerState.h"
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+const char* const PhazerState::xmlTagName = "Phazer_Settings";
+
+// Same as the parameter IDs
+static const char* const morphPresetIDs[] = { "morpha", "morphb", "morphc", "morphd" };
+
+static_assert (std::is_trivially_copyable<PhazerState>::value, "the state is saved and loaded with memcpy");
+
+bool PhazerState::read (const void* data, size_t numBytes) noexcept
+{
+    const size_t headerSize = offsetof (PhazerState, rate);
+
+    if (data == nullptr || numBytes < headerSize)
+        return false;
+
+    PhazerState loaded;
+    memcpy (static_cast<void*> (&loaded), data, headerSize);
+
+    if (loaded.magicNumber != (uint32) magic || loaded.size < headerSize)
+        return false;
+
+    // Whatever part of the record both versions know about, over the defaults
+    memcpy (static_cast<void*> (&loaded), data, jmin (numBytes, (size_t) loaded.size, sizeof (PhazerState)));
+
+    loaded.version = currentVersion;
+    loaded.size = sizeof (PhazerState);
+
+    // The host may hand back anything. jlimit lets NaN through, so anything
+    // that isn't a finite number goes back to its default first.
+    const PhazerState defaults;
+    auto finiteOrDefault = [] (float& value, float defaultValue) { if (! std::isfinite (value)) value = defaultValue; };
+
+    finiteOrDefault (loaded.rate, defaults.rate);
+    finiteOrDefault (loaded.depth, defaults.depth);
+    finiteOrDefault (loaded.width, defaults.width);
+    finiteOrDefault (loaded.centerfreq, defaults.centerfreq);
+    finiteOrDefault (loaded.mix, defaults.mix);
+    finiteOrDefault (loaded.morphX, defaults.morphX);
+    finiteOrDefault (loaded.morphY, defaults.morphY);
+
+    for (int i = 0; i < 3; ++i)
+        finiteOrDefault (loaded.ICs[i], defaults.ICs[i]);
+
+    // and keep it all in range
+    loaded.setParameters (loaded.getParameters());
+    loaded.oscillatorType = jlimit ((int32) Oscillators::Sine, (int32) Oscillators::Lorenz, loaded.oscillatorType);
+
+    for (auto& ic : loaded.ICs)
+        ic = jlimit (-1.0f, 1.0f, ic);
+
+    loaded.uiWidth = jmax (loaded.uiWidth, 400);
+    loaded.uiHeight = jmax (loaded.uiHeight, 200);
+
+    loaded.morphMode = jlimit (0, 2, loaded.morphMode);
+    loaded.morphX = jlimit (0.0f, 1.0f, loaded.morphX);
+    loaded.morphY = jlimit (0.0f, 1.0f, loaded.morphY);
+
+    for (auto& preset : loaded.morphPresets)
+        preset = jlimit (0, 127, preset);
+
+    *this = loaded;
+    return true;
+}
+
+void PhazerState::write (MemoryBlock& destData) const
+{
+    destData.replaceWith (this, sizeof (PhazerState));
+}
+
+PhazerParameters PhazerState::getParameters() const noexcept
+{
+    PhazerParameters params;
+    params.rate = rate;
+    params.depth = depth;
+    params.width = width;
+    params.centerfreq = centerfreq;
+    params.mix = mix;
+    params.stages = stages;
+    params.power = power != 0;
+    params.oversampling = oversampling;
+    params.limit();
+    return params;
+}
+
+void PhazerState::setParameters (const PhazerParameters& params) noexcept
+{
+    rate = params.rate;
+    depth = params.depth;
+    width = params.width;
+    centerfreq = params.centerfreq;
+    mix = params.mix;
+    stages = params.stages;
+    power = params.power ? 1 : 0;
+    oversampling = params.oversampling;
+}
+
+//==============================================================================
+// Attributes use the parameter IDs
+XmlElement* PhazerState::createXml() const
+{
+    auto* xml = new XmlElement (xmlTagName);
+
+    xml->setAttribute ("version", (int) version);
+    xml->setAttribute ("rate", rate);
+    xml->setAttribute ("depth", depth);
+    xml->setAttribute ("width", width);
+    xml->setAttribute ("freq", centerfreq);
+    xml->setAttribute ("mix", mix);
+    xml->setAttribute ("stages", (int) stages);
+    xml->setAttribute ("power", (int) power);
+    xml->setAttribute ("osc", (int) oscillatorType);
+    xml->setAttribute ("ic1", ICs[0]);
+    xml->setAttribute ("ic2", ICs[1]);
+    xml->setAttribute ("ic3", ICs[2]);
+    xml->setAttribute ("uiWidth", (int) uiWidth);
+    xml->setAttribute ("uiHeight", (int) uiHeight);
+    xml->setAttribute ("morph", (int) morphMode);
+    xml->setAttribute ("morphx", morphX);
+    xml->setAttribute ("morphy", morphY);
+
+    for (int i = 0; i < 4; ++i)
+        xml->setAttribute (morphPresetIDs[i], (int) morphPresets[i]);
+
+    xml->setAttribute ("oversampling", (int) oversampling);
+    return xml;
+}
+
+bool PhazerState::loadFromXml (const XmlElement& xml)
+{
+    if (! xml.hasTagName (xmlTagName))
+        return false;
+
+    // Goes through read() so the XML gets the same range checks as a binary state
+    PhazerState loaded (*this);
+
+    loaded.rate = (float) xml.getDoubleAttribute ("rate", rate);
+    loaded.depth = (float) xml.getDoubleAttribute ("depth", depth);
+    loaded.width = (float) xml.getDoubleAttribute ("width", width);
+    loaded.centerfreq = (float) xml.getDoubleAttribute ("freq", centerfreq);
+    loaded.mix = (float) xml.getDoubleAttribute ("mix", mix);
+    loaded.stages = xml.getIntAttribute ("stages", stages);
+    loaded.power = xml.getIntAttribute ("power", power);
+    loaded.oscillatorType = xml.getIntAttribute ("osc", oscillatorType);
+    loaded.ICs[0] = (float) xml.getDoubleAttribute ("ic1", ICs[0]);
+    loaded.ICs[1] = (float) xml.getDoubleAttribute ("ic2", ICs[1]);
+    loaded.ICs[2] = (float) xml.getDoubleAttribute ("ic3", ICs[2]);
+    loaded.uiWidth = xml.getIntAttribute ("uiWidth", uiWidth);
+    loaded.uiHeight = xml.getIntAttribute ("uiHeight", uiHeight);
+    loaded.morphMode = xml.getIntAttribute ("morph", morphMode);
+    loaded.morphX = (float) xml.getDoubleAttribute ("morphx", morphX);
+    loaded.morphY = (float) xml.getDoubleAttribute ("morphy", morphY);
+
+    for (int i = 0; i < 4; ++i)
+        loaded.morphPresets[i] = xml.getIntAttribute (morphPresetIDs[i], morphPresets[i]);
+
+    loaded.oversampling = xml.getIntAttribute ("oversampling", oversampling);
+    return read (&loaded, sizeof (loaded));
+}
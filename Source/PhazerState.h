@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    PhazerState.h
+    Author:  eric carmi
+
+    Everything the plugin saves with a session, as one fixed-size binary record.
+
+    The record is written to the host exactly as it sits in memory, and loading
+    it back is a single memcpy: there is nothing to parse, so a session with
+    hundreds of instances loads without Phazer showing up in a profile.
+
+    Versions only ever append fields. A loader copies as much of a record as it
+    knows about over the defaults, so an older record gets defaults for the
+    newer fields and a newer record's extra fields are ignored. Existing fields
+    are never moved, resized or reused. All fields are 32 bit and stored in the
+    machine's byte order, which is little-endian on every platform we build for.
+
+    The XML form is only for debugging, to read a saved state or to hand-edit
+    one. Building with PHAZER_XML_STATE=1 makes getStateInformation() save it
+    in place of the record, and setStateInformation() always accepts it.
+
+  ==============================================================================
+*/
+
+#ifndef PHAZERSTATE_H_INCLUDED
+#define PHAZERSTATE_H_INCLUDED
+
+#include "PhazerEngine.h"
+
+#ifndef PHAZER_XML_STATE
+ #define PHAZER_XML_STATE 0
+#endif
+
+struct PhazerState
+{
+    enum
+    {
+        magic = 0x525a4850,         // "PHZR" in a little-endian dump
+        currentVersion = 3
+    };
+
+    // Header, the same in every version
+    uint32 magicNumber = magic;
+    uint16 version = currentVersion;
+    uint16 size = sizeof (PhazerState);
+
+    // Version 1
+    float rate = 0.5f;
+    float depth = 0.8f;
+    float width = 0.5f;
+    float centerfreq = 999.977f;
+    float mix = 0.0f;
+    int32 stages = 4;
+    int32 power = 1;
+    int32 oscillatorType = Oscillators::Sine;
+    float ICs[3] = { 0.0f, 0.0f, 0.0f };
+    int32 uiWidth = 400;
+    int32 uiHeight = 450;
+
+    // Version 2, see PresetMorph.h
+    int32 morphMode = 0;
+    float morphX = 0.0f;
+    float morphY = 0.0f;
+    int32 morphPresets[4] = { 0, 1, 2, 3 };
+
+    // Version 3, log2 of the factor, see Oversampler.h
+    int32 oversampling = 0;
+
+    //==============================================================================
+    // Loads a record of any version. Returns false, leaving this state
+    // untouched, if the data isn't one of ours.
+    bool read (const void* data, size_t numBytes) noexcept;
+
+    void write (MemoryBlock& destData) const;
+
+    PhazerParameters getParameters() const noexcept;
+    void setParameters (const PhazerParameters& params) noexcept;
+
+    //==============================================================================
+    XmlElement* createXml() const;
+    bool loadFromXml (const XmlElement& xml);
+
+    static const char* const xmlTagName;
+};
+
+#endif  // PHAZERSTATE_H_INCLUDED
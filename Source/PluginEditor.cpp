@@ -1,15 +1,13 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
-class PhazerAudioProcessorEditor::ParameterSlider   : public Slider,
-                                                      private Timer
+class PhazerAudioProcessorEditor::ParameterSlider   : public Slider
 {
 public:
     ParameterSlider (AudioProcessorParameter& p)
         : Slider (p.getName (256)), param (p)
     {
         setRange (0.0, 1.0, 0.0);
-        startTimerHz (30);
         updateSliderPos();
 
     }
@@ -19,20 +17,32 @@ public:
         param.setValueNotifyingHost ((float) Slider::getValue());
     }
 
-    void timerCallback() override       { updateSliderPos(); }
-
     void startedDragging() override     { param.beginChangeGesture(); }
     void stoppedDragging() override     { param.endChangeGesture();   }
 
     double getValueFromText (const String& text) override   { return param.getValueForText (text); }
     String getTextFromValue (double value) override         { return param.getText ((float) value, 1024) + getTextValueSuffix(); }
 
-    void updateSliderPos()
+    // Called by the editor's refresh clock. Only touches the slider when the
+    // parameter has moved since it last did, and returns whether it had.
+    bool updateSliderPos()
     {
         const float newValue = param.getValue();
 
-        if (newValue != (float) Slider::getValue() && ! isMouseButtonDown())
-            Slider::setValue (newValue);
+        if (newValue == lastValue)
+            return false;
+
+        // While it's being dragged this keeps reporting a change, so the
+        // slider catches up with the parameter once it's let go
+        if (! isMouseButtonDown())
+        {
+            lastValue = newValue;
+
+            if (newValue != (float) Slider::getValue())
+                Slider::setValue (newValue);
+        }
+
+        return true;
     }
 
     void mouseDown(const MouseEvent& e) override
@@ -53,12 +63,23 @@ public:
     }
 
     AudioProcessorParameter& param;
+    float lastValue = -1.0f;    // parameters are normalised to 0..1
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParameterSlider)
 };
 
 struct PhazerAudioProcessorEditor::CustomLookAndFeel    : public LookAndFeel_V3
 {
+    CustomLookAndFeel()
+    {
+        setupCustomLookAndFeelColours(*this);
+    }
+
+    // Labels copy these, so each family is looked up once per process rather than per label
+    const Font labelFont    { String("Superclarendon"), 25.0f, Font::bold };
+    const Font resetFont    { String("Superclarendon"), 20.0f, Font::bold };
+    const Font titleFont    { String("Arial"), 30.0f, Font::bold };
+    const Font statusFont   { String("Arial"), 14.0f, Font::plain };
 
     void drawRotarySlider (Graphics& g, int x, int y, int width, int height, float sliderPos,
                            float rotaryStartAngle, float rotaryEndAngle, Slider& slider) override
@@ -72,24 +93,23 @@ struct PhazerAudioProcessorEditor::CustomLookAndFeel    : public LookAndFeel_V3
         const float angle = rotaryStartAngle + sliderPos * (rotaryEndAngle - rotaryStartAngle);
         const bool isMouseOver = slider.isMouseOverOrDragging() && slider.isEnabled();
 
+        const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const KnobImages& images = getKnobImages (Rectangle<int> (x, y, width, height), rotaryStartAngle, rotaryEndAngle, scale);
+        const AffineTransform imageToSlider (AffineTransform::scale (1.0f / scale).translated ((float) x, (float) y));
+
         if (slider.isEnabled())
             g.setColour (slider.findColour (Slider::rotarySliderFillColourId).withAlpha (isMouseOver ? 1.0f : 0.7f));
         else
             g.setColour (Colour (0x80808080));
 
         {
-            Rectangle<float> r (rx, ry, rw, rw);
             Path filledArc;
             filledArc.addPieSegment (rx, ry, rw, rw, rotaryStartAngle, angle, 0.8);
-            //filledArc.addPieSegment (rx, ry, rw, rw, rotaryStartAngle, rotaryStartAngle+2*double_Pi, 0.1);
             g.fillPath (filledArc);
 
-            Path knob;
-            knob.addEllipse(rx, ry, rw, rw);
-            knob.applyTransform(AffineTransform::scale(0.8, 0.8, centreX, centreY));
-            g.setColour(Colours::black);
-            g.setGradientFill(ColourGradient(Colours::lightgrey, centreX*.3, centreY*.3, Colours::black, centreX, centreY, true));
-            g.fillPath(knob);
+            // The arc's colour would make the images translucent
+            g.setOpacity (1.0f);
+            g.drawImageTransformed (images.body, imageToSlider);
 
             Path needle;
             const double mangle = angle - double_Pi/2.0;
@@ -98,15 +118,78 @@ struct PhazerAudioProcessorEditor::CustomLookAndFeel    : public LookAndFeel_V3
             g.fillPath(needle);
 
         }
+
+        g.drawImageTransformed (images.outline, imageToSlider);
+    }
+
+    //==============================================================================
+    // The knob body and the outline don't move with the value, so they're drawn
+    // once for each slider area, angle range and display scale and blitted from
+    // then on; only the value arc and the needle are paths on every repaint.
+    struct KnobImages
+    {
+        Rectangle<int> area;
+        float startAngle, endAngle, scale;
+        Image body, outline;
+    };
+
+    const KnobImages& getKnobImages (Rectangle<int> area, float startAngle, float endAngle, float scale)
+    {
+        for (auto& k : knobImages)
+            if (k.area == area && k.startAngle == startAngle && k.endAngle == endAngle && k.scale == scale)
+                return k;
+
+        // Every knob in every open editor normally shares a handful of these
+        if (knobImages.size() >= maxCachedKnobs)
+            knobImages.remove (0);
+
+        KnobImages k;
+        k.area = area;
+        k.startAngle = startAngle;
+        k.endAngle = endAngle;
+        k.scale = scale;
+
+        const int imageWidth = jmax (1, roundToInt (area.getWidth() * scale));
+        const int imageHeight = jmax (1, roundToInt (area.getHeight() * scale));
+        k.body = Image (Image::ARGB, imageWidth, imageHeight, true);
+        k.outline = Image (Image::ARGB, imageWidth, imageHeight, true);
+
+        // Drawn in the slider's coordinates, as drawRotarySlider used to
+        const AffineTransform sliderToImage (AffineTransform::translation ((float) -area.getX(), (float) -area.getY()).scaled (scale));
+        const float radius = jmin (area.getWidth() / 2, area.getHeight() / 2) - 2.0f;
+        const float centreX = area.getX() + area.getWidth() * 0.5f;
+        const float centreY = area.getY() + area.getHeight() * 0.5f;
+        const float rx = centreX - radius;
+        const float ry = centreY - radius;
+        const float rw = radius * 2.0f;
+
+        {
+            Graphics g (k.body);
+            g.addTransform (sliderToImage);
+
+            Path knob;
+            knob.addEllipse(rx, ry, rw, rw);
+            knob.applyTransform(AffineTransform::scale(0.8, 0.8, centreX, centreY));
+            g.setGradientFill(ColourGradient(Colours::lightgrey, centreX*.3, centreY*.3, Colours::black, centreX, centreY, true));
+            g.fillPath(knob);
+        }
         {
+            Graphics g (k.outline);
+            g.addTransform (sliderToImage);
             g.setColour(Colours::black);
 
-            const float lineThickness = jmin (15.0f, jmin (width, height) * 0.45f) * 0.1f;
+            const float lineThickness = jmin (15.0f, jmin (area.getWidth(), area.getHeight()) * 0.45f) * 0.1f;
             Path outlineArc;
-            outlineArc.addPieSegment (rx, ry, rw, rw, rotaryStartAngle, rotaryEndAngle, 0.8);
+            outlineArc.addPieSegment (rx, ry, rw, rw, startAngle, endAngle, 0.8);
             g.strokePath (outlineArc, PathStrokeType (lineThickness));
         }
+
+        knobImages.add (k);
+        return knobImages.getReference (knobImages.size() - 1);
     }
+
+    enum { maxCachedKnobs = 16 };
+    Array<KnobImages> knobImages;
 };
 
 void PhazerAudioProcessorEditor::setupCustomLookAndFeelColours (LookAndFeel_V3& laf)
@@ -138,9 +221,10 @@ PhazerAudioProcessorEditor::PhazerAudioProcessorEditor(PhazerAudioProcessor& own
       resetLabel(String(),"rst")
 
 {
+    const int64 constructionStart = Time::getHighResolutionTicks();
+    openStartTicks = constructionStart;
 
-    CustomLookAndFeel* claf = new CustomLookAndFeel();
-    setupCustomLookAndFeelColours(*claf);
+    CustomLookAndFeel* claf = lookAndFeel;
 
     Path circleButton;
     circleButton.addEllipse(0, 0, 20, 20);
@@ -168,30 +252,6 @@ PhazerAudioProcessorEditor::PhazerAudioProcessorEditor(PhazerAudioProcessor& own
   //  rateSlider->setPopupDisplayEnabled(true, true, nullptr);
 
 
-    addAndMakeVisible(IC1Slider = new ParameterSlider (*getProcessor().IC1Param));
-    IC1Slider->setSliderStyle(Slider::Rotary);
-    IC1Slider->setTextBoxStyle(Slider::TextBoxBelow, false, 0, 0);
-    IC1Slider->setLookAndFeel(claf);
-    IC1Slider->setColour(Slider::rotarySliderFillColourId, Colours::red);
-    IC1Slider->setVisible(false);
-  //  IC1Slider->setPopupDisplayEnabled(true, true, nullptr);
-
-    addAndMakeVisible(IC2Slider = new ParameterSlider (*getProcessor().IC2Param));
-    IC2Slider->setSliderStyle(Slider::Rotary);
-    IC2Slider->setTextBoxStyle(Slider::TextBoxBelow, false, 0, 0);
-    IC2Slider->setLookAndFeel(claf);
-    IC2Slider->setColour(Slider::rotarySliderFillColourId, Colours::green);
-    IC2Slider->setVisible(false);
-  //  IC2Slider->setPopupDisplayEnabled(true, true, nullptr);
-
-    addAndMakeVisible(IC3Slider = new ParameterSlider (*getProcessor().IC3Param));
-    IC3Slider->setSliderStyle(Slider::Rotary);
-    IC3Slider->setTextBoxStyle(Slider::TextBoxBelow, false, 0, 0);
-    IC3Slider->setLookAndFeel(claf);
-    IC3Slider->setColour(Slider::rotarySliderFillColourId, Colours::blue);
-    IC3Slider->setVisible(false);
-  //  IC3Slider->setPopupDisplayEnabled(true, true, nullptr);
-
     addAndMakeVisible(depthSlider = new ParameterSlider (*getProcessor().depthParam));
     depthSlider->setSliderStyle(Slider::Rotary);
     depthSlider->setTextBoxStyle(Slider::TextBoxBelow, false, 60, 20);
@@ -221,49 +281,52 @@ PhazerAudioProcessorEditor::PhazerAudioProcessorEditor(PhazerAudioProcessor& own
     //centerfreqSlider->setPopupDisplayEnabled(true, true, nullptr);
     centerfreqSlider->setTextValueSuffix(" Hz");
 
+    // The IC sliders join these when they're first shown, see createICSliders()
+    ParameterSlider* const sliders[] = { rateSlider, depthSlider, ratedepthSlider, centerfreqSlider, mixSlider };
+    parameterSliders.addArray(sliders, numElementsInArray(sliders));
+
     // Setup the labels
     rateLabel.setColour(Label::textColourId, Colours::black);
-    rateLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    rateLabel.setFont (claf->labelFont);
     rateLabel.setJustificationType(Justification::centred);
     rateLabel.attachToComponent (rateSlider, false);
 
     icLabel.setColour(Label::textColourId, Colours::black);
-    icLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    icLabel.setFont (claf->labelFont);
     icLabel.setJustificationType(Justification::centred);
-    icLabel.attachToComponent (IC2Slider, true);
 
     depthLabel.setColour(Label::textColourId, Colours::black);
-    depthLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    depthLabel.setFont (claf->labelFont);
     depthLabel.setJustificationType(Justification::centred);
     depthLabel.attachToComponent (depthSlider, false);
 
     ratedepthLabel.setColour(Label::textColourId, Colours::black);
-    ratedepthLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    ratedepthLabel.setFont (claf->labelFont);
     ratedepthLabel.setJustificationType(Justification::centred);
     ratedepthLabel.attachToComponent (ratedepthSlider, false);
 
     mixLabel.setColour(Label::textColourId, Colours::black);
-    mixLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    mixLabel.setFont (claf->labelFont);
     mixLabel.setJustificationType(Justification::centred);
     mixLabel.attachToComponent (mixSlider, false);
 
     centerfreqLabel.setColour(Label::textColourId, Colours::black);
-    centerfreqLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    centerfreqLabel.setFont (claf->labelFont);
     centerfreqLabel.setJustificationType(Justification::centred);
     centerfreqLabel.attachToComponent (centerfreqSlider, false);
 
     addAndMakeVisible(companyLabel);
-    companyLabel.setFont (Font(String("Arial"), 30.0f, Font::bold));
+    companyLabel.setFont (claf->titleFont);
     companyLabel.setColour(Label::textColourId, Colours::goldenrod);
 
     addAndMakeVisible(stageLabel);
     stageLabel.setColour(Label::textColourId, Colours::black);
-    stageLabel.setFont (Font(String("Superclarendon"), 25.0f, Font::bold));
+    stageLabel.setFont (claf->labelFont);
     stageLabel.setJustificationType(Justification::centred);
 
     addAndMakeVisible(resetLabel);
     resetLabel.setColour(Label::textColourId, Colours::black);
-    resetLabel.setFont (Font(String("Superclarendon"), 20.0f, Font::bold));
+    resetLabel.setFont (claf->resetFont);
     //resetLabel.attachToComponent(&resetICsButton, false);
     resetLabel.setJustificationType(Justification::bottom);
     resetLabel.setVisible(false);
@@ -320,11 +383,46 @@ PhazerAudioProcessorEditor::PhazerAudioProcessorEditor(PhazerAudioProcessor& own
     oscillatorBox.addItem("Duffing", 8);
     oscillatorBox.addItem("Chua", 9);
     oscillatorBox.addItem("Lorenz", 10);
-    oscillatorBox.setSelectedId(1);
+    oscillatorBox.setSelectedId(owner.engine.oscillator.getType());
     oscillatorBox.addListener(this);
 
+    addAndMakeVisible(oversamplingBox);
+    for(int i = 0; i <= Oversampler::maxFactorLog2; ++i)
+        oversamplingBox.addItem(String(1 << i) + "x", i + 1);
+    oversamplingBox.setSelectedId(*owner.oversamplingParam + 1, dontSendNotification);
+    oversamplingBox.addListener(this);
+
+    // The labels that change on every refresh paint their own background, so
+    // updating them doesn't repaint the editor behind
+    addAndMakeVisible(telemetryLabel);
+    telemetryLabel.setColour(Label::textColourId, Colours::white);
+    telemetryLabel.setColour(Label::backgroundColourId, Colours::black);
+    telemetryLabel.setOpaque(true);
+    telemetryLabel.setFont (claf->statusFont);
+    telemetryLabel.setJustificationType(Justification::centredRight);
+    owner.engine.telemetry.skipToEnd(telemetryReader);
+
+    addAndMakeVisible(responseDisplay);
+    addChildComponent(lfoScope);
+
+    addAndMakeVisible(loadLabel);
+    loadLabel.setColour(Label::textColourId, Colours::black);
+    loadLabel.setColour(Label::backgroundColourId, Colours::slategrey);
+    loadLabel.setOpaque(true);
+    loadLabel.setFont (claf->statusFont);
+    loadLabel.setJustificationType(Justification::centred);
+    loadLabel.addMouseListener(this, false);
+    startTimerHz(activeRefreshRate);
+
+    // The controls for the running oscillator are there for the first paint,
+    // the notification from setSelectedId() then finds nothing to change
+    handleAsyncUpdate();
+    setOpaque(true);
+
     // set our component's initial size to be the last one that was stored in the filter's settings
     setSize (owner.lastUIWidth,owner.lastUIHeight);
+
+    constructorMillis = 1000.0 * Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - constructionStart);
 }
 
 PhazerAudioProcessorEditor::~PhazerAudioProcessorEditor()
@@ -332,6 +430,56 @@ PhazerAudioProcessorEditor::~PhazerAudioProcessorEditor()
 
 }
 
+void PhazerAudioProcessorEditor::createICSliders()
+{
+    CustomLookAndFeel* claf = lookAndFeel;
+
+    addChildComponent(IC1Slider = new ParameterSlider (*getProcessor().IC1Param));
+    IC1Slider->setSliderStyle(Slider::Rotary);
+    IC1Slider->setTextBoxStyle(Slider::TextBoxBelow, false, 0, 0);
+    IC1Slider->setLookAndFeel(claf);
+    IC1Slider->setColour(Slider::rotarySliderFillColourId, Colours::red);
+  //  IC1Slider->setPopupDisplayEnabled(true, true, nullptr);
+
+    addChildComponent(IC2Slider = new ParameterSlider (*getProcessor().IC2Param));
+    IC2Slider->setSliderStyle(Slider::Rotary);
+    IC2Slider->setTextBoxStyle(Slider::TextBoxBelow, false, 0, 0);
+    IC2Slider->setLookAndFeel(claf);
+    IC2Slider->setColour(Slider::rotarySliderFillColourId, Colours::green);
+  //  IC2Slider->setPopupDisplayEnabled(true, true, nullptr);
+
+    addChildComponent(IC3Slider = new ParameterSlider (*getProcessor().IC3Param));
+    IC3Slider->setSliderStyle(Slider::Rotary);
+    IC3Slider->setTextBoxStyle(Slider::TextBoxBelow, false, 0, 0);
+    IC3Slider->setLookAndFeel(claf);
+    IC3Slider->setColour(Slider::rotarySliderFillColourId, Colours::blue);
+  //  IC3Slider->setPopupDisplayEnabled(true, true, nullptr);
+
+    icLabel.attachToComponent (IC2Slider, true);
+
+    parameterSliders.add(IC1Slider);
+    parameterSliders.add(IC2Slider);
+    parameterSliders.add(IC3Slider);
+
+    resized();
+}
+
+void PhazerAudioProcessorEditor::setICSlidersVisible (bool shouldBeVisible)
+{
+    // Most sessions never pick a chaotic oscillator, so they're only built once one does
+    if(IC1Slider == nullptr)
+    {
+        if(! shouldBeVisible)
+            return;
+
+        createICSliders();
+    }
+
+    IC1Slider->setVisible(shouldBeVisible);
+    IC2Slider->setVisible(shouldBeVisible);
+    IC3Slider->setVisible(shouldBeVisible);
+}
+
 void PhazerAudioProcessorEditor::switchStage(Button* button)
 {
 
@@ -364,7 +512,7 @@ void PhazerAudioProcessorEditor::switchStage(Button* button)
     if(button == &powerButton)
     {
         bool onoff = *getProcessor().powerParam;
-        getProcessor().crossFadeFlag = true;    // Always triggered whenever power is switched either way
+        getProcessor().engine.crossFadeFlag = true;    // Always triggered whenever power is switched either way
                                                 // Will be set to false within the processor
         *getProcessor().powerParam = not onoff;
         if(onoff)
@@ -381,10 +529,8 @@ void PhazerAudioProcessorEditor::switchStage(Button* button)
 
     if(button == &resetICsButton)
     {
-        double ics[3] =  {IC1Slider->getValue(),IC2Slider->getValue(),IC3Slider->getValue()};
-        *getProcessor().ICs = *ics;
-        getProcessor().resetICflag = true;
-
+        // From the parameters, Duffing and Vanderpol have the button without the sliders
+        getProcessor().resetICs();
     }
 }
 
@@ -393,61 +539,201 @@ void PhazerAudioProcessorEditor::comboBoxChanged(ComboBox *box)
     if(box == &oscillatorBox)
     {
         const int osc = oscillatorBox.getSelectedId();
-        getProcessor().oscillator.setType(osc);
 
-        if(osc == (Oscillators::Sine) || osc == (Oscillators::Triangle) || osc == (Oscillators::Square) || osc == (Oscillators::Saw) || osc == (Oscillators::AASaw) || osc == (Oscillators::AASquare))
-        {
-            rateSlider->setVisible(true);
+        // Also called when the editor opens, don't restart a running oscillator
+        if(osc != getProcessor().engine.oscillator.getType())
+            getProcessor().engine.oscillator.setType(osc);
 
-            IC1Slider->setVisible(false);
-            IC2Slider->setVisible(false);
-            IC3Slider->setVisible(false);
-            resetICsButton.setVisible(false);
-            resetLabel.setVisible(false);
-        }
+        // The controls follow in one go on the next message, however many changes come before it
+        triggerAsyncUpdate();
+    }
+    else if(box == &oversamplingBox)
+    {
+        *getProcessor().oversamplingParam = oversamplingBox.getSelectedId() - 1;
+    }
+}
 
-        // Duffing and Vanderpol have frequency control and sensitivity to ICs
-        else if(osc == Oscillators::Duffing || osc == Oscillators::Vanderpol)
-        {
-            rateSlider->setVisible(true);
-            resetICsButton.setVisible(true);
-            resetLabel.setVisible(true);
+void PhazerAudioProcessorEditor::handleAsyncUpdate()
+{
+    const int osc = oscillatorBox.getSelectedId();
 
-            IC1Slider->setVisible(false);
-            IC2Slider->setVisible(false);
-            IC3Slider->setVisible(false);
-        }
+    if(osc == layoutOscillator)
+        return;
 
-        else
-        {
-            rateSlider->setVisible(false);
+    layoutOscillator = osc;
 
-            IC1Slider->setVisible(true);
-            IC2Slider->setVisible(true);
-            IC3Slider->setVisible(true);
-            resetICsButton.setVisible(true);
-            resetLabel.setVisible(true);
-        }
+    const bool periodic = ! Oscillators::isDynamical(osc);
+
+    // Duffing and Vanderpol have frequency control and sensitivity to ICs,
+    // Chua and Lorenz have IC sliders in place of the rate control
+    const bool usesICSliders = ! periodic && osc != Oscillators::Duffing && osc != Oscillators::Vanderpol;
+
+    // Each of these only repaints its own area, and only if it actually changes
+    rateSlider->setVisible(! usesICSliders);
+    setICSlidersVisible(usesICSliders);
+    resetICsButton.setVisible(! periodic);
+    resetLabel.setVisible(! periodic);
+
+    // The chaotic oscillators show their scope in place of the response
+    responseDisplay.setVisible(periodic);
+
+    if(! periodic)
+        lfoScope.setOscillatorType(osc);
+
+    lfoScope.setVisible(! periodic);
+}
+
+
+void PhazerAudioProcessorEditor::timerCallback()
+{
+    bool changed = false;
+
+    for (auto* slider : parameterSliders)
+        changed |= slider->updateSliderPos();
+
+    changed |= refreshStatus();
+
+    // Nothing to show wakes the message thread far less often, until something moves again
+    if (changed)
+    {
+        framesWithoutChange = 0;
+
+        if (getTimerInterval() != 1000 / activeRefreshRate)
+            startTimerHz(activeRefreshRate);
+    }
+    else if (++framesWithoutChange == activeRefreshRate)
+    {
+        startTimerHz(idleRefreshRate);
+    }
+}
+
+bool PhazerAudioProcessorEditor::refreshStatus()
+{
+    bool changed = false;
+
+    // A program change may have switched the oscillator
+    const int oscType = getProcessor().engine.oscillator.getType();
+
+    if (oscillatorBox.getSelectedId() != oscType)
+    {
+        oscillatorBox.setSelectedId(oscType);
+        changed = true;
+    }
+
+    // Or the host may have changed the oversampling
+    const int oversamplingId = *getProcessor().oversamplingParam + 1;
+
+    if (oversamplingBox.getSelectedId() != oversamplingId)
+    {
+        oversamplingBox.setSelectedId(oversamplingId, dontSendNotification);
+        changed = true;
+    }
+
+    // Red while a block in the last few seconds missed its deadline
+    const LoadMeter& meter = getProcessor().loadMeter;
+    const Colour loadColour (meter.getPeakLoad() > 1.0f ? Colours::red : Colours::black);
+    const String loadText ("CPU " + String(100.0f * meter.getRecentLoad(), 1) + "%");
+
+    if (loadText != loadLabel.getText() || loadColour != loadLabel.findColour(Label::textColourId))
+    {
+        loadLabel.setColour(Label::textColourId, loadColour);
+        loadLabel.setText(loadText, dontSendNotification);
+        changed = true;
+    }
+
+    // Hidden, the scope's feed is only kept from filling up
+    if (lfoScope.isVisible())
+        changed |= lfoScope.update(getProcessor().engine.scope);
+    else
+        getProcessor().engine.scope.skipToEnd();
+
+    TelemetryRecord records[32];
+    int numRead, numTotal = 0;
+    uint32 events = 0;
+    TelemetryRecord latest;
+
+    while ((numRead = getProcessor().engine.telemetry.read(telemetryReader, records, numElementsInArray(records))) > 0)
+    {
+        for (int i = 0; i < numRead; ++i)
+            events |= records[i].events;
+
+        latest = records[numRead - 1];
+        numTotal += numRead;
     }
+
+    if (numTotal == 0)
+        return changed;
+
+    // Notch position follows the LFO, turns red when the watchdog saw something
+    const Colour telemetryColour (events != 0 ? Colours::red : Colours::white);
+    const String telemetryText (String(roundToInt(latest.notchFreq)) + " Hz");
+
+    if (telemetryText != telemetryLabel.getText() || telemetryColour != telemetryLabel.findColour(Label::textColourId))
+    {
+        telemetryLabel.setColour(Label::textColourId, telemetryColour);
+        telemetryLabel.setText(telemetryText, dontSendNotification);
+        changed = true;
+    }
+
+    // Only evaluated and repainted when the coefficients moved
+    changed |= responseDisplay.setCoefficients(latest.allpassRe, latest.allpassZ2, latest.stages, latest.mix,
+                                               getProcessor().engine.getSampleRate());
+    return changed;
+}
+
+void PhazerAudioProcessorEditor::mouseDown (const MouseEvent& e)
+{
+    if (e.eventComponent != &loadLabel)
+        return;
+
+    const String report (getProcessor().loadMeter.getReport()
+                          + "editor opened in " + String(openMillis, 1) + " ms, "
+                          + String(constructorMillis, 1) + " ms of it in the constructor\n");
+    Logger::writeToLog(report);
+    SystemClipboard::copyTextToClipboard(report);
+
+   #if PHAZER_TRACE
+    const File trace (File::getSpecialLocation(File::tempDirectory).getChildFile("phazer-trace.json"));
+
+    if (TraceEvents::writeChromeJson(trace))
+        Logger::writeToLog("Trace written to " + trace.getFullPathName());
+   #endif
 }
 
 //==============================================================================
 void PhazerAudioProcessorEditor::paint (Graphics& g)
 {
+    // Graphics is clipped to what was invalidated, less the opaque children, so
+    // only those parts of the background and the top bar are filled, each once
+    const Rectangle<int> topBar (0, 0, getWidth(), 30);
+
+    if(g.clipRegionIntersects(topBar))
+    {
+        g.setColour(Colours::black);
+        g.fillRect(topBar);
+    }
+
     g.setColour(Colours::slategrey);
-    g.fillAll();
-    g.setColour(Colours::black);
-    g.fillRect(0, 0, getWidth(), 30);
+    g.fillRect(getLocalBounds().withTrimmedTop(topBar.getHeight()));
+}
 
+void PhazerAudioProcessorEditor::paintOverChildren (Graphics&)
+{
+    // Everything has been drawn once by the end of the first of these
+    if(openMillis == 0.0)
+        openMillis = 1000.0 * Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - openStartTicks);
 }
 
 void PhazerAudioProcessorEditor::resized()
 {
 
     // IC sliders replace rate control when a chaotic oscillator is selected
-    IC1Slider->setBounds           (40,    30,  75, 75);
-    IC2Slider->setBounds           (40,    105,  75, 75);
-    IC3Slider->setBounds           (40,    180,  75, 75);
+    if(IC1Slider != nullptr)
+    {
+        IC1Slider->setBounds       (40,    30,  75, 75);
+        IC2Slider->setBounds       (40,    105,  75, 75);
+        IC3Slider->setBounds       (40,    180,  75, 75);
+    }
     rateSlider->setBounds          (0,   55,  150, 150);
     resetICsButton.setBounds       (5,    230,   25, 25);
     resetLabel.setBounds           (0,    205,   30, 25);
@@ -463,8 +749,13 @@ void PhazerAudioProcessorEditor::resized()
 
     powerButton.setBounds(getWidth()-30,5,25,25);
     oscillatorBox.setBounds(0, 0, 100, 30);
+    oversamplingBox.setBounds(100, 0, 50, 30);
     stageLabel.setBounds(155, 30, 90, 40);
     companyLabel.setBounds(getWidth()/2-50 , 0, 100, 30);
+    telemetryLabel.setBounds(getWidth()/2+50, 0, getWidth()/2-85, 30);
+    responseDisplay.setBounds(getWidth()/2-50, getHeight()-128, 100, 96);
+    lfoScope.setBounds(responseDisplay.getBounds());
+    loadLabel.setBounds(getWidth()/2-50, getHeight()-30, 100, 25);
 
     getProcessor().lastUIWidth = getWidth();
     getProcessor().lastUIHeight = getHeight();
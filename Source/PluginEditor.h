@@ -4,13 +4,17 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "PluginProcessor.h"
+#include "ResponseDisplay.h"
+#include "LfoScope.h"
 
 //==============================================================================
 /** This is the editor component that our filter will display.
 */
 class PhazerAudioProcessorEditor  : public AudioProcessorEditor,
                                     public Button::Listener,
-                                    public ComboBox::Listener
+                                    public ComboBox::Listener,
+                                    private Timer,
+                                    private AsyncUpdater
 {
 public:
     PhazerAudioProcessorEditor (PhazerAudioProcessor&);
@@ -18,14 +22,20 @@ public:
 
     //==============================================================================
     void paint (Graphics&) override;
+    void paintOverChildren (Graphics&) override;
     void resized() override;
 
-    void setupCustomLookAndFeelColours  (LookAndFeel_V3& laf);
+    static void setupCustomLookAndFeelColours  (LookAndFeel_V3& laf);
 
 private:
 
     class ParameterSlider;
     struct CustomLookAndFeel;
+
+    // One look and feel, its knob images and fonts for every editor in the process,
+    // deleted with the last of them. Declared first so it outlives the sliders.
+    SharedResourcePointer<CustomLookAndFeel> lookAndFeel;
+
     TextButton stage4Button, stage8Button, stage12Button, stage16Button, chorusButton;
 
     Colour powerOn = Colours::green;
@@ -41,12 +51,50 @@ private:
 
     void comboBoxChanged(ComboBox* box) override;
 
+    // Shows the controls for the selected oscillator, coalesced from comboBoxChanged()
+    void handleAsyncUpdate() override;
+    int layoutOscillator = 0;
+
+    // The editor's one refresh clock: polls the parameter sliders, the oscillator,
+    // the load meter and the telemetry stream. It drops from activeRefreshRate to
+    // idleRefreshRate after a second in which none of them changed.
+    void timerCallback() override;
+    bool refreshStatus();
+
+    enum { activeRefreshRate = 30, idleRefreshRate = 5 };
+    int framesWithoutChange = 0;
+
+    TelemetryStream::Reader telemetryReader;
+    Label telemetryLabel;
+
+    // Magnitude and phase response of the cascade in the latest telemetry record.
+    // The chaotic oscillators show their scope in its place.
+    ResponseDisplay responseDisplay;
+    LfoScope lfoScope;
+
+    // Recent processBlock load, clicking it writes the full report to the log and the clipboard,
+    // and with PHAZER_TRACE the trace events to phazer-trace.json in the temp folder
+    Label loadLabel;
+    void mouseDown (const MouseEvent& e) override;
+
     ComboBox oscillatorBox;
 
+    // 1x to 8x, each item's ID is the oversampling parameter plus one
+    ComboBox oversamplingBox;
+
     Label rateLabel, depthLabel, ratedepthLabel, mixLabel, centerfreqLabel, companyLabel, stageLabel, icLabel, resetLabel;
     ScopedPointer<ParameterSlider> rateSlider, depthSlider, ratedepthSlider, centerfreqSlider, mixSlider, stageSlider;
-    // Sliders for controlling initial conditions of chaotic oscillators
+    // Sliders for controlling initial conditions of chaotic oscillators, null until first shown
     ScopedPointer<ParameterSlider> IC1Slider, IC2Slider, IC3Slider;
+    Array<ParameterSlider*> parameterSliders;
+
+    void createICSliders();
+    void setICSlidersVisible (bool shouldBeVisible);
+
+    // Time from the start of the constructor to the end of the first paint, and the
+    // constructor's share of it, for the load report
+    int64 openStartTicks = 0;
+    double constructorMillis = 0.0, openMillis = 0.0;
 
     //==============================================================================
     PhazerAudioProcessor& getProcessor() const
@@ -8,8 +8,7 @@ PhazerAudioProcessor::PhazerAudioProcessor()
       depthParam (nullptr),
       widthParam (nullptr),
       centerfreqParam(nullptr),
-      mixParam(nullptr),
-      LFOcounter(0)
+      mixParam(nullptr)
 
 {
     addParameter(rateParam = new AudioParameterFloat ("rate", "Rate", 0.001f, 20.0f, 0.5f));
@@ -23,11 +22,23 @@ PhazerAudioProcessor::PhazerAudioProcessor()
     addParameter(IC2Param = new AudioParameterFloat ("ic2", "Ic2", -1.0f, 1.0f, 0.0f));
     addParameter(IC3Param = new AudioParameterFloat ("ic3", "Ic3", -1.0f, 1.0f, 0.0f));
 
-    oscillator.setType(Oscillators::Sine);
+    addParameter(morphModeParam = new AudioParameterInt ("morph", "Morph", PresetMorph::off, PresetMorph::fourPresets, PresetMorph::off));
+    addParameter(morphXParam = new AudioParameterFloat ("morphx", "Morph X", 0.0f, 1.0f, 0.0f));
+    addParameter(morphYParam = new AudioParameterFloat ("morphy", "Morph Y", 0.0f, 1.0f, 0.0f));
+
+    addParameter(morphPresetParams[0] = new AudioParameterInt ("morpha", "Morph A", 0, 127, 0));
+    addParameter(morphPresetParams[1] = new AudioParameterInt ("morphb", "Morph B", 0, 127, 1));
+    addParameter(morphPresetParams[2] = new AudioParameterInt ("morphc", "Morph C", 0, 127, 2));
+    addParameter(morphPresetParams[3] = new AudioParameterInt ("morphd", "Morph D", 0, 127, 3));
+
+    addParameter(oversamplingParam = new AudioParameterInt ("oversampling", "Oversampling", 0, Oversampler::maxFactorLog2, 0));
+
+    presetBank.open(PresetBank::getDefaultFile());
 }
 
 PhazerAudioProcessor::~PhazerAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -76,16 +87,13 @@ bool PhazerAudioProcessor::producesMidi() const
 //==============================================================================
 void PhazerAudioProcessor::prepareToPlay (double newSampleRate, int samplesPerBlock)
 {
-    crossFadeBuffer.setSize(2, samplesPerBlock);
+    engine.prepare(newSampleRate, samplesPerBlock);
+    engine.setOversampling(*oversamplingParam);
+    reportedLatency = engine.getLatencySamples();
+    latencyToPublish = -1;
+    setLatencySamples(reportedLatency);
+    loadMeter.prepare(newSampleRate);
 
-    SMmix.reset(newSampleRate, 0.1);
-    SMrate.reset(newSampleRate, 0.1);
-    SMwidth.reset(newSampleRate, 0.1);
-    SMcenterfreq.reset(newSampleRate, 0.1);
-    SMdepth.reset(newSampleRate, 0.1);
-
-    LFOangle = 0.0;
-    oscillator.setSampleRate(newSampleRate);
     reset();
 }
 
@@ -94,6 +102,7 @@ void PhazerAudioProcessor::releaseResources()
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
     //keyboardState.reset();
+    engine.release();
 }
 
 void PhazerAudioProcessor::reset()
@@ -104,157 +113,99 @@ void PhazerAudioProcessor::reset()
 
 void PhazerAudioProcessor::process (AudioBuffer<float>& buffer,MidiBuffer& midiMessages)
 {
-    const int numSamples = buffer.getNumSamples();
-
     for (int i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
-        buffer.clear (i, 0, numSamples);
+        buffer.clear (i, 0, buffer.getNumSamples());
+
+    PhazerParameters params;
 
-    effectOn = *powerParam;
-    if(effectOn)
     {
-        mainEffectLoop(buffer);
+        PHAZER_TRACE_SCOPE (parameterRead);
+        readParameters(midiMessages, params);
     }
 
-    if(crossFadeFlag)
-    {
-        // Mix the newly processed buffer with the previous buffer
-        // Old buffer starts with amplitude of 1, decreases to 0; vice versa for new buffer
-        const float del = (double)(1.0/numSamples);
+    engine.process(buffer, params);
 
-        for(int chan = 0; chan > buffer.getNumChannels(); ++chan)
-        {
-            float* newBuff = buffer.getWritePointer(chan);
-            float* oldBuff = crossFadeBuffer.getWritePointer(chan);
-
-            for(int samp = 0; samp < numSamples; ++samp)
-            {
-                const float outSamp = newBuff[samp]*(samp+del) + oldBuff[samp]*(1-(samp+del));
-                newBuff[samp] = outSamp;
-            }
-        }
-        crossFadeFlag = false;
+    // A new oversampling factor has a new latency, which the host
+    // is told about from the message thread
+    if(engine.getLatencySamples() != reportedLatency)
+    {
+        reportedLatency = engine.getLatencySamples();
+        latencyToPublish = reportedLatency;
+        triggerAsyncUpdate();
     }
-
-    crossFadeBuffer.makeCopyOf(buffer);
 }
 
-void PhazerAudioProcessor::mainEffectLoop (AudioBuffer<float>& buffer)
+void PhazerAudioProcessor::readParameters (MidiBuffer& midiMessages, PhazerParameters& params)
 {
-    nums = buffer.getNumSamples();
-    chans = buffer.getNumChannels();
-    sampRate = getSampleRate();
-    sampTime = 1.0/sampRate;
-    Omega = 2.0 * double_Pi / sampRate;
-
-    SMrate.setValue(*rateParam);
-    SMdepth.setValue(*depthParam);
-    SMwidth.setValue(*widthParam);
-    SMmix.setValue(*mixParam);
-    SMcenterfreq.setValue(*centerfreqParam);
-    SMnumstages.setValue(*stageParam);
-
-    if(resetICflag)
+    // Raw bytes, a MidiMessage could allocate for a long sysex
+    MidiBuffer::Iterator midiIterator (midiMessages);
+    const uint8* midiData;
+    int numBytes, samplePosition;
+
+    while(midiIterator.getNextEvent(midiData, numBytes, samplePosition))
+        if(numBytes >= 2 && (midiData[0] & 0xf0) == 0xc0)
+            setCurrentProgram(midiData[1]);
+
+    const int program = pendingProgram.exchange(-1);
+
+    if(const PhazerState* preset = presetBank.getPreset(program))
     {
-        oscillator.resetICs(ICs);
-        resetICflag = false;
+        // The engine takes the program now, the parameters follow from the message thread
+        applyOscillator(*preset);
+        currentProgram = program;
+
+        loadingProgram = preset;
+        programToPublish = program;
+        triggerAsyncUpdate();
     }
-    if( chans == 2 )
+    else if(loadingProgram != nullptr && programToPublish.load() < 0)
     {
-
-        float* leftChannel = buffer.getWritePointer (0);
-        float* rightChannel = buffer.getWritePointer (1);
-
-        for( int samp = 0; samp < nums; samp++)
-        {
-            leftin = leftChannel[samp];
-            rightin = rightChannel[samp];
-
-            rate = SMrate.getNextValue();
-            depth = SMdepth.getNextValue();
-            width = SMwidth.getNextValue();
-            mix = SMmix.getNextValue();
-            centerfreq = SMcenterfreq.getNextValue();
-
-            // Smoothing number of stages does not help artifacts while changing it quickly.
-            // Might need to do some sort of cross fade buffer
-            numStages = static_cast<int>(SMnumstages.getNextValue());
-
-            LFOdelta = Omega*rate;
-            LFOangle += LFOdelta;
-
-            oscillator.setFrequency(rate);
-            oscillator.getNextSample(osc, 0.0);
-            BW = centerfreq/3 * width;
-            Re = -2.0*depth * cos(Omega*(centerfreq + BW*osc[0]));
-            z2 = depth*depth;
-
-            a0 = 1.0;
-            a1 = Re;
-            a2 = z2;
-            b0 = z2;
-            b1 = Re;
-            b2 = 1.0;
-
-            leftout = leftin;
-            rightout = rightin;
-
-            filterAP1L.setCoefficients(IIRCoefficients(b0,b1,b2,a0,a1,a2));
-            filterAP1R.setCoefficients(IIRCoefficients(b0,b1,b2,a0,a1,a2));
-
-            for(int stage = 0; stage < 4*numStages; ++stage)
-            {
-                leftout = filterAP1L.processSingleSampleRaw(leftout);
-                rightout = filterAP1R.processSingleSampleRaw(rightout);
-            }
-
-            leftChannel[samp]  = leftin + leftout * mix;
-            rightChannel[samp] = rightin  + rightout * mix;
-        }
+        loadingProgram = nullptr;
     }
 
-    if( chans == 1 )
-    {
-        float* leftChannel = buffer.getWritePointer (0);
+    const PhazerState current (loadingProgram != nullptr ? *loadingProgram : getParameterState());
 
-        for( int samp = 0; samp < nums; samp++)
-        {
+    params = current.getParameters();
+    params.oversampling = *oversamplingParam;       // not part of a program
 
-            leftin = leftChannel[samp];
+    const int restoredOscillator = pendingOscillator.exchange(-1);
 
-            rate = SMrate.getNextValue();
-            depth = SMdepth.getNextValue();
-            width = SMwidth.getNextValue();
-            mix = SMmix.getNextValue();
-            centerfreq = SMcenterfreq.getNextValue();
-            numStages = static_cast<int>(SMnumstages.getNextValue());
+    if(restoredOscillator >= 0)
+    {
+        PhazerState restored (current);
+        restored.oscillatorType = restoredOscillator;
+        applyOscillator(restored);
+    }
 
-            LFOdelta = Omega*rate;
-            LFOangle += LFOdelta;
+    if(icResetPending.exchange(false))
+    {
+        for(int i = 0; i < 3; ++i)
+            engine.ICs[i] = current.ICs[i];
 
-            oscillator.setFrequency(rate);
-            oscillator.getNextSample(osc, 0.0);
-            BW = centerfreq/3 * width;
-            Re = -2.0*depth * cos(Omega*(centerfreq + BW*osc[0]));
-            z2 = depth*depth;
+        engine.resetICflag = true;
+    }
 
-            a0 = 1.0;
-            a1 = Re;
-            a2 = z2;
-            b0 = z2;
-            b1 = Re;
-            b2 = 1.0;
+    const PresetMorph::Mode morphMode = (PresetMorph::Mode) current.morphMode;
 
-            float leftout = leftin;
-            filterAP1L.setCoefficients(IIRCoefficients(b0,b1,b2,a0,a1,a2));
+    if(morphMode != PresetMorph::off)
+    {
+        for(int i = 0; i < 4; ++i)
+            morph.setCorner(i, presetBank.getPreset(current.morphPresets[i]));
 
-            for(int stage = 0; stage < 4*numStages; ++stage)
-            {
-                leftout = filterAP1L.processSingleSampleRaw(leftout);
-            }
+        morph.process(params, morphMode, current.morphX, current.morphY);
 
-            leftChannel[samp]  = leftin  + leftout * mix;
+        // Restarting the dynamical oscillators every block would stop them,
+        // so they only pick up the blended ICs when the morph is switched on
+        if(lastMorphMode == PresetMorph::off && Oscillators::isDynamical(engine.oscillator.getType()))
+        {
+            for(int i = 0; i < 3; ++i)
+                engine.ICs[i] = morph.getIC(i);
+
+            engine.resetICflag = true;
         }
     }
+
+    lastMorphMode = morphMode;
 }
 
 //==============================================================================
@@ -266,44 +217,148 @@ AudioProcessorEditor* PhazerAudioProcessor::createEditor()
 //==============================================================================
 void PhazerAudioProcessor::getStateInformation (MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // Here's an example of how you can use XML to make it easy and more robust:
-//
-//    // Create an outer XML element..
-//    ScopedPointer<XmlElement> xml (parameters.state.createXml());
-//
-////    // add some attributes to it..
-//    xml->setAttribute ("uiWidth", lastUIWidth);
-//    xml->setAttribute ("uiHeight", lastUIHeight);
-//
-//    // Store the values of all our parameters, using their param ID as the XML attribute
-//    copyXmlToBinary (*xml, destData);
-
+   #if PHAZER_XML_STATE
+    ScopedPointer<XmlElement> xml (getCurrentState().createXml());
+    copyXmlToBinary(*xml, destData);
+   #else
+    getCurrentState().write(destData);
+   #endif
 }
 
 void PhazerAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-
-//    // This getXmlFromBinary() helper function retrieves our XML from the binary blob..
-//    ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
-//
-//    if (xmlState != nullptr)
-//    {
-//        // make sure that it's actually our type of XML object..
-//        if (xmlState->hasTagName ("Phazer_Settings"))
-//        {
-//            // ok, now pull out our last window size..
-//            lastUIWidth  = jmax (xmlState->getIntAttribute ("uiWidth", lastUIWidth), 400);
-//            lastUIHeight = jmax (xmlState->getIntAttribute ("uiHeight", lastUIHeight), 200);
-//
-//            ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
-//            if (xmlState != nullptr)
-//                if (xmlState->hasTagName (parameters.state.getType()))
-//                    parameters.state = ValueTree::fromXml (*xmlState);
-//        }
-//    }
+    PhazerState state (getCurrentState());
+
+    if(state.read(data, (size_t) jmax(0, sizeInBytes)))
+    {
+        applyState(state);
+        return;
+    }
+
+    // Not a binary state, maybe XML saved for debugging
+    ScopedPointer<XmlElement> xmlState (getXmlFromBinary (data, sizeInBytes));
+
+    if(xmlState != nullptr && state.loadFromXml(*xmlState))
+        applyState(state);
+}
+
+PhazerState PhazerAudioProcessor::getCurrentState() const
+{
+    PhazerState state (getParameterState());
+
+    // A restored state the audio thread hasn't picked up yet is still the current one
+    const int restoredOscillator = pendingOscillator.load();
+    state.oscillatorType = restoredOscillator >= 0 ? restoredOscillator : engine.oscillator.getType();
+    state.uiWidth = lastUIWidth;
+    state.uiHeight = lastUIHeight;
+    return state;
+}
+
+// What the parameter objects hold, so everything but the oscillator and the editor size
+PhazerState PhazerAudioProcessor::getParameterState() const
+{
+    PhazerState state;
+
+    state.rate = *rateParam;
+    state.depth = *depthParam;
+    state.width = *widthParam;
+    state.centerfreq = *centerfreqParam;
+    state.mix = *mixParam;
+    state.stages = *stageParam;
+    state.power = *powerParam ? 1 : 0;
+    state.ICs[0] = *IC1Param;
+    state.ICs[1] = *IC2Param;
+    state.ICs[2] = *IC3Param;
+    state.morphMode = *morphModeParam;
+    state.morphX = *morphXParam;
+    state.morphY = *morphYParam;
+
+    for(int i = 0; i < 4; ++i)
+        state.morphPresets[i] = *morphPresetParams[i];
+
+    state.oversampling = *oversamplingParam;
+    return state;
+}
+
+void PhazerAudioProcessor::applyState (const PhazerState& state)
+{
+    // The ICs go into the parameters first, so the audio thread
+    // has them when it sees the oscillator
+    applyParameters(state);
+    pendingOscillator = state.oscillatorType;
+
+    // Not part of a program, switching it clears the filters and moves the latency
+    *oversamplingParam = state.oversampling;
+
+    lastUIWidth = state.uiWidth;
+    lastUIHeight = state.uiHeight;
+}
+
+// Everything in a program but the oscillator, on the message thread
+void PhazerAudioProcessor::applyParameters (const PhazerState& state)
+{
+    *rateParam = state.rate;
+    *depthParam = state.depth;
+    *widthParam = state.width;
+    *centerfreqParam = state.centerfreq;
+    *mixParam = state.mix;
+    *stageParam = state.stages;
+    *powerParam = state.power != 0;
+    *IC1Param = state.ICs[0];
+    *IC2Param = state.ICs[1];
+    *IC3Param = state.ICs[2];
+    *morphModeParam = state.morphMode;
+    *morphXParam = state.morphX;
+    *morphYParam = state.morphY;
+
+    for(int i = 0; i < 4; ++i)
+        *morphPresetParams[i] = state.morphPresets[i];
+}
+
+// On the audio thread, as it restarts the oscillator
+void PhazerAudioProcessor::applyOscillator (const PhazerState& state)
+{
+    // setType() restarts the oscillator, so leave it running if nothing changed
+    if(state.oscillatorType != engine.oscillator.getType())
+        engine.oscillator.setType(state.oscillatorType);
+
+    // Only the dynamical systems start from their ICs
+    if(Oscillators::isDynamical(state.oscillatorType))
+    {
+        for(int i = 0; i < 3; ++i)
+            engine.ICs[i] = state.ICs[i];
+
+        engine.resetICflag = true;
+    }
+}
+
+//==============================================================================
+int PhazerAudioProcessor::getCurrentProgram()
+{
+    const int pending = pendingProgram.load();
+    return pending >= 0 ? pending : currentProgram.load();
+}
+
+void PhazerAudioProcessor::setCurrentProgram (int index)
+{
+    if(presetBank.getPreset(index) != nullptr)
+        pendingProgram = index;
+}
+
+void PhazerAudioProcessor::handleAsyncUpdate()
+{
+    int program = programToPublish.load();
+
+    if(const PhazerState* preset = presetBank.getPreset(program))
+        applyParameters(*preset);
+
+    // A program that came in meanwhile stays, and has an update of its own coming
+    programToPublish.compare_exchange_strong(program, -1);
+
+    const int latency = latencyToPublish.exchange(-1);
+
+    if(latency >= 0)
+        setLatencySamples(latency);
 }
 
 //==============================================================================
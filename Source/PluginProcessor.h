@@ -10,17 +10,24 @@
 #define PLUGINPROCESSOR_H_INCLUDED
 
 #include "../JuceLibraryCode/JuceHeader.h"
-#include "Oscillators.h"
+#include "PhazerEngine.h"
+#include "PhazerState.h"
+#include "PresetBank.h"
+#include "PresetMorph.h"
+#include "LoadMeter.h"
+#include <atomic>
 
 class PhazerAudioProcessor  : public AudioProcessor,
-                              public IIRFilter,
-                              public IIRCoefficients
+                              private AsyncUpdater
 {
 public:
     //==============================================================================
     PhazerAudioProcessor();
     ~PhazerAudioProcessor();
 
+    // The engine is aligned to a cache line
+    PHAZER_DECLARE_ALIGNED_NEW (PhazerAudioProcessor)
+
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -30,7 +37,9 @@ public:
     void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midiMessages) override
     {
         //jassert (! isUsingDoublePrecision());
+        const int64 startTicks = Time::getHighResolutionTicks();
         process (buffer, midiMessages);
+        loadMeter.addBlock (Time::getHighResolutionTicks() - startTicks, buffer.getNumSamples());
     }
 
     #ifndef JucePlugin_PreferredChannelConfigurations
@@ -50,16 +59,26 @@ public:
     double getTailLengthSeconds() const override                                { return 0.0; }
 
     //==============================================================================
-    int getNumPrograms() override                                               { return 1; }
-    int getCurrentProgram() override                                            { return 0; }
-    void setCurrentProgram (int /*index*/) override                             {}
-    const String getProgramName (int /*index*/) override                        { return String(); }
+    // The programs are the presets in PresetBank::getDefaultFile(). A program
+    // change, from the host or a MIDI program change, applies at the next block,
+    // and the parameters follow from the message thread.
+    int getNumPrograms() override                                               { return jmax (1, presetBank.getNumPresets()); }
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const String getProgramName (int index) override                           { return presetBank.getName (index); }
     void changeProgramName (int /*index*/, const String& /*name*/) override     {}
 
     //==============================================================================
     void getStateInformation (MemoryBlock&) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    // Restarts a dynamical oscillator from the IC parameters at the next block
+    void resetICs()                                                             { icResetPending = true; }
+
+    // The parameters, oscillator and editor size, see PhazerState.h
+    PhazerState getCurrentState() const;
+    void applyState (const PhazerState& state);
+
     int lastUIWidth, lastUIHeight;
 
     AudioParameterFloat* rateParam;
@@ -73,40 +92,59 @@ public:
     AudioParameterBool* powerParam;
     AudioParameterInt* stageParam;
 
-    Oscillators oscillator;
-    bool crossFadeFlag = false;
+    // Morphing between presets from the bank, see PresetMorph.h
+    AudioParameterInt* morphModeParam;
+    AudioParameterFloat* morphXParam;
+    AudioParameterFloat* morphYParam;
+    AudioParameterInt* morphPresetParams[4];
+
+    // Log2 of the oversampling factor, see Oversampler.h
+    AudioParameterInt* oversamplingParam;
 
-    IIRFilter filterAP1L, filterAP1R;
-    IIRFilter APtype2L, APtype2R;
-    IIRCoefficients coeff;
+    // The DSP, see PhazerEngine.h
+    PhazerEngine engine;
 
-    double ICs[3] = {0.0f, 0.0f, 0.0f};
-    bool resetICflag = false;
+    // Time taken by each processBlock call against its real-time budget
+    LoadMeter loadMeter;
 
 private:
     //==============================================================================
     void process (AudioBuffer<float>& buffer, MidiBuffer& midiMessages);
-    void mainEffectLoop (AudioBuffer<float>& buffer);
-    // Crossfade buffer is used to smooth transitions between switching the effect on and off
-    // When power is switched, the effect will slowly come in
-    // This requires copying every buffer into the crossfade buffer until it is needed
-    AudioBuffer<float> crossFadeBuffer;
-
-    int LFOcounter;
-    double LFOangle, LFOdelta;
-
-    bool effectOn = true;
-    bool apType = false;
-    double sampRate, sampTime, Omega;
-    int nums, chans;
-    float rate, depth, width, mix, centerfreq, BW;
-    float tau, bAP0, bAP1, aAP0, aAP1;
-    int numStages;
-    float osc[3];
-    double a0, a1, a2, b0, b1, b2, Re, z2;
-    float leftin, rightin, leftout, rightout;
-
-    LinearSmoothedValue<double> SMdepth, SMrate, SMwidth, SMcenterfreq, SMmix, SMnumstages;
+
+    // Program changes, the parameters and the morph, into params
+    void readParameters (MidiBuffer& midiMessages, PhazerParameters& params);
+    PhazerState getParameterState() const;
+
+    // Setting the parameter objects notifies the host, so it's only done on the
+    // message thread. The oscillator and its ICs go into the engine on the audio thread.
+    void applyParameters (const PhazerState& state);
+    void applyOscillator (const PhazerState& state);
+
+    // Publishes a program the audio thread has loaded to the parameters,
+    // and a new latency to the host
+    void handleAsyncUpdate() override;
+
+    PresetBank presetBank;
+    std::atomic<int> currentProgram { 0 };
+    std::atomic<int> pendingProgram { -1 };
+
+    // The audio thread reads a new program from the bank until the message
+    // thread has set the parameters to it and cleared programToPublish
+    const PhazerState* loadingProgram = nullptr;
+    std::atomic<int> programToPublish { -1 };
+
+    std::atomic<bool> icResetPending { false };
+
+    // The oscillator of a restored state, for the audio thread to switch to.
+    // Its ICs are in the parameters by then.
+    std::atomic<int> pendingOscillator { -1 };
+
+    // The latency the audio thread last asked the message thread to report
+    int reportedLatency = 0;
+    std::atomic<int> latencyToPublish { -1 };
+
+    PresetMorph morph;
+    int lastMorphMode = PresetMorph::off;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PhazerAudioProcessor)
 };
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    PresetBank.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "PresetBank.h"
+
+PresetBank::PresetBank()
+{
+}
+
+PresetBank::~PresetBank()
+{
+}
+
+File PresetBank::getDefaultFile()
+{
+    return File::getSpecialLocation (File::userApplicationDataDirectory)
+             .getChildFile ("Phazer").getChildFile ("Presets.phazerbank");
+}
+
+bool PresetBank::open (const File& file)
+{
+    mappedFile = nullptr;
+    records = nullptr;
+    recordSize = 0;
+    presets.clearQuick();
+
+    ScopedPointer<MemoryMappedFile> mapped (new MemoryMappedFile (file, MemoryMappedFile::readOnly));
+    const size_t fileSize = mapped->getSize();
+
+    if (mapped->getData() == nullptr || fileSize < sizeof (FileHeader))
+        return false;
+
+    FileHeader header;
+    memcpy (&header, mapped->getData(), sizeof (FileHeader));
+
+    if (header.magicNumber != (uint32) magic || header.recordSize <= nameLength)
+        return false;
+
+    // A truncated file keeps the presets that are complete
+    const size_t numComplete = (fileSize - sizeof (FileHeader)) / header.recordSize;
+    const int numPresets = (int) jmin ((size_t) header.numPresets, numComplete);
+    const char* data = static_cast<const char*> (mapped->getData()) + sizeof (FileHeader);
+
+    presets.ensureStorageAllocated (numPresets);
+
+    for (int i = 0; i < numPresets; ++i)
+    {
+        PhazerState state;
+
+        if (! state.read (data + (size_t) i * header.recordSize + nameLength, header.recordSize - (size_t) nameLength))
+            break;
+
+        presets.add (state);
+    }
+
+    mappedFile = mapped.release();
+    records = data;
+    recordSize = header.recordSize;
+
+    return presets.size() > 0;
+}
+
+String PresetBank::getName (int index) const
+{
+    if (! isPositiveAndBelow (index, presets.size()))
+        return {};
+
+    const char* name = records + (size_t) index * recordSize;
+    int length = 0;
+
+    while (length < nameLength && name[length] != 0)
+        ++length;
+
+    return String::fromUTF8 (name, length);
+}
+
+const PhazerState* PresetBank::getPreset (int index) const noexcept
+{
+    return isPositiveAndBelow (index, presets.size()) ? presets.begin() + index : nullptr;
+}
+
+bool PresetBank::write (const File& file, const StringArray& names, const Array<PhazerState>& states)
+{
+    jassert (names.size() == states.size());
+
+    FileHeader header;
+    header.magicNumber = magic;
+    header.version = currentVersion;
+    header.recordSize = (uint16) (nameLength + sizeof (PhazerState));
+    header.numPresets = (uint32) states.size();
+    header.reserved = 0;
+
+    MemoryBlock data (sizeof (FileHeader) + (size_t) states.size() * header.recordSize, true);
+    char* dest = static_cast<char*> (data.getData());
+    memcpy (dest, &header, sizeof (FileHeader));
+
+    for (int i = 0; i < states.size(); ++i)
+    {
+        char* record = dest + sizeof (FileHeader) + (size_t) i * header.recordSize;
+
+        // Long names are cut to the whole characters that fit, the rest stays zero
+        names[i].copyToUTF8 (record, nameLength);
+
+        memcpy (record + nameLength, &states.getReference (i), sizeof (PhazerState));
+    }
+
+    return file.getParentDirectory().createDirectory().wasOk()
+        && file.replaceWithData (data.getData(), data.getSize());
+}
@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Author:  eric carmi
+
+    A bank of presets in one file, shown to the host as the plugin's programs.
+
+    The file is a small header followed by fixed-size records, each a name and
+    a PhazerState:
+
+        header  magic "PHZB", version, record size, number of presets
+        record  name (32 bytes of UTF-8, zero padded), PhazerState, padding
+
+    The record size comes from the header, so a bank written with an older or
+    newer PhazerState still loads. Names are read straight out of the mapped
+    file. The states are copied out once when the bank is opened, so switching
+    programs on the audio thread is a plain copy from memory that's already
+    resident, with no page faults into the file.
+
+  ==============================================================================
+*/
+
+#ifndef PRESETBANK_H_INCLUDED
+#define PRESETBANK_H_INCLUDED
+
+#include "PhazerState.h"
+
+class PresetBank
+{
+public:
+    PresetBank();
+    ~PresetBank();
+
+    // Presets.phazerbank in the user's application data folder
+    static File getDefaultFile();
+
+    // Replaces the current bank. Not safe while the audio thread may be
+    // reading presets, so the processor only calls it from its constructor.
+    bool open (const File& file);
+
+    int getNumPresets() const noexcept                  { return presets.size(); }
+
+    String getName (int index) const;
+
+    // The decoded preset, or nullptr if the index is out of range.
+    // Doesn't allocate or touch the file, so it's fine on the audio thread.
+    const PhazerState* getPreset (int index) const noexcept;
+
+    // Writes a bank that open() can read
+    static bool write (const File& file, const StringArray& names, const Array<PhazerState>& states);
+
+private:
+    struct FileHeader
+    {
+        uint32 magicNumber;
+        uint16 version;
+        uint16 recordSize;
+        uint32 numPresets;
+        uint32 reserved;
+    };
+
+    enum
+    {
+        magic = 0x425a4850,         // "PHZB" in a little-endian dump
+        currentVersion = 1,
+        nameLength = 32
+    };
+
+    ScopedPointer<MemoryMappedFile> mappedFile;
+    const char* records = nullptr;
+    size_t recordSize = 0;
+    Array<PhazerState> presets;
+
+    JUCE_DECLARE_NON_COPYABLE (PresetBank)
+};
+
+#endif  // PRESETBANK_H_INCLUDED
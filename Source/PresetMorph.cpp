@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    PresetMorph.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "PresetMorph.h"
+
+PresetMorph::PresetMorph()
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        presets[i] = nullptr;
+        decode (corners[i], PhazerParameters(), nullptr);
+    }
+
+    decode (blended, PhazerParameters(), nullptr);
+}
+
+void PresetMorph::decode (float* values, const PhazerParameters& params, const float* ICs) noexcept
+{
+    values[logRate] = std::log (params.rate);
+    values[depth] = params.depth;
+    values[width] = params.width;
+    values[logCenterfreq] = std::log (params.centerfreq);
+    values[mix] = params.mix;
+
+    for (int i = 0; i < 3; ++i)
+        values[ic1 + i] = ICs != nullptr ? ICs[i] : 0.0f;
+}
+
+void PresetMorph::setCorner (int corner, const PhazerState* preset) noexcept
+{
+    jassert (isPositiveAndBelow (corner, 4));
+
+    if (preset == presets[corner])
+        return;
+
+    presets[corner] = preset;
+
+    if (preset != nullptr)
+        decode (corners[corner], preset->getParameters(), preset->ICs);
+}
+
+void PresetMorph::process (PhazerParameters& params, Mode mode, float x, float y) noexcept
+{
+    if (mode == off)
+        return;
+
+    x = jlimit (0.0f, 1.0f, x);
+    y = mode == fourPresets ? jlimit (0.0f, 1.0f, y) : 0.0f;
+
+    const int numCorners = mode == fourPresets ? 4 : 2;
+    const float weights[4] = { (1.0f - x) * (1.0f - y), x * (1.0f - y), (1.0f - x) * y, x * y };
+
+    // Corners without a preset take the knob settings, the ICs of those stay at 0
+    float knobs[numValues];
+    bool knobsDecoded = false;
+
+    for (int v = 0; v < numValues; ++v)
+        blended[v] = 0.0f;
+
+    for (int c = 0; c < numCorners; ++c)
+    {
+        const float* values = corners[c];
+
+        if (presets[c] == nullptr)
+        {
+            if (! knobsDecoded)
+            {
+                decode (knobs, params, nullptr);
+                knobsDecoded = true;
+            }
+
+            values = knobs;
+        }
+
+        for (int v = 0; v < numValues; ++v)
+            blended[v] += weights[c] * values[v];
+    }
+
+    params.rate = std::exp (blended[logRate]);
+    params.depth = blended[depth];
+    params.width = blended[width];
+    params.centerfreq = std::exp (blended[logCenterfreq]);
+    params.mix = blended[mix];
+    params.limit();
+}
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    PresetMorph.h
+    Author:  eric carmi
+
+    Blends the continuous settings of two or four presets: rate, depth, width,
+    centre frequency, mix and the oscillator ICs.
+
+    With two presets, x moves from A to B. With four they sit on the corners of
+    a square, A bottom left, B bottom right, C top left, D top right, and x, y
+    pick a point inside it.
+
+    Runs on the audio thread once per block. A corner is decoded into a flat
+    array only when its preset changes (rate and frequency are kept as logs so
+    they blend evenly in octaves), after that a block costs one weighted sum
+    per value and two exp() calls. The engine's smoothers take care of the
+    ramp between blocks, exactly as they do for a knob.
+
+  ==============================================================================
+*/
+
+#ifndef PRESETMORPH_H_INCLUDED
+#define PRESETMORPH_H_INCLUDED
+
+#include "PhazerState.h"
+
+class PresetMorph
+{
+public:
+    enum Mode
+    {
+        off = 0,
+        twoPresets = 1,
+        fourPresets = 2
+    };
+
+    PresetMorph();
+
+    // A null preset makes the corner follow the knobs
+    void setCorner (int corner, const PhazerState* preset) noexcept;
+
+    // Replaces the continuous values in params with the blend at x, y (0 to 1).
+    // Stages and power stay as they are.
+    void process (PhazerParameters& params, Mode mode, float x, float y) noexcept;
+
+    // The blended ICs from the last process()
+    float getIC (int index) const noexcept          { return blended[ic1 + index]; }
+
+private:
+    enum Value
+    {
+        logRate, depth, width, logCenterfreq, mix, ic1, ic2, ic3,
+        numValues
+    };
+
+    static void decode (float* values, const PhazerParameters& params, const float* ICs) noexcept;
+
+    const PhazerState* presets[4];
+    float corners[4][numValues];
+    float blended[numValues];
+
+    JUCE_DECLARE_NON_COPYABLE (PresetMorph)
+};
+
+#endif  // PRESETMORPH_H_INCLUDED
@@ -0,0 +1,222 @@
+/*
+  ==============================================================================
+
+    ResponseDisplay.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "ResponseDisplay.h"
+
+ResponseDisplay::ResponseDisplay()
+{
+    setOpaque (true);
+    setInterceptsMouseClicks (false, false);
+}
+
+ResponseDisplay::~ResponseDisplay()
+{
+}
+
+bool ResponseDisplay::setCoefficients (float allpassRe, float allpassZ2, int stages, float newMix, double newSampleRate)
+{
+    if (allpassRe == re && allpassZ2 == z2 && stages == numStages && newMix == mix
+         && newSampleRate == sampleRate && ! needsEvaluating)
+        return false;
+
+    const bool rateChanged = newSampleRate != sampleRate;
+
+    re = allpassRe;
+    z2 = allpassZ2;
+    numStages = stages;
+    mix = newMix;
+    sampleRate = newSampleRate;
+
+    if (rateChanged)
+        prepareBins();
+
+    evaluate();
+    repaint();
+    return true;
+}
+
+void ResponseDisplay::resized()
+{
+    prepareBins();
+    evaluate();
+}
+
+void ResponseDisplay::prepareBins()
+{
+    numBins = jmax (0, getWidth());
+
+    for (auto* block : { &frequencies, &cos1, &sin1, &cos2, &sin2, &real, &imag, &decibels, &phases })
+        block->malloc ((size_t) jmax (1, numBins));
+
+    if (numBins == 0 || sampleRate <= 0.0)
+    {
+        numBins = 0;
+        return;
+    }
+
+    const float topFrequency = jmin (maxFrequency, (float) (0.49 * sampleRate));
+    const double logStep = std::log (topFrequency / minFrequency) / jmax (1, numBins - 1);
+
+    for (int i = 0; i < numBins; ++i)
+    {
+        frequencies[i] = (float) (minFrequency * std::exp (logStep * i));
+
+        const double w = 2.0 * double_Pi * frequencies[i] / sampleRate;
+        cos1[i] = (float) std::cos (w);
+        sin1[i] = (float) std::sin (w);
+        cos2[i] = (float) std::cos (2.0 * w);
+        sin2[i] = (float) std::sin (2.0 * w);
+    }
+}
+
+void ResponseDisplay::evaluate()
+{
+    needsEvaluating = false;
+    notches.clearQuick();
+    magnitudePath.clear();
+    phasePath.clear();
+
+    const int n = numBins;
+
+    if (n == 0)
+        return;
+
+    // The 4 * stages passes of one sample as a single system with two states.
+    // A pass with input u and state (v1, v2) is
+    //     y = b0 u + v1,  v1' = b1 u - a1 y + v2,  v2' = b2 u - a2 y
+    // with b0 = a2 = z2, b1 = a1 = Re and b2 = 1. Starting from the identity,
+    // each pass maps the state and the signal so far to the next ones.
+    double A[2][2] = { { 1.0, 0.0 }, { 0.0, 1.0 } };
+    double b[2] = { 0.0, 0.0 }, c[2] = { 0.0, 0.0 }, d = 1.0;
+
+    {
+        const double a1 = re, a2 = z2, b0 = z2, b1 = re, b2 = 1.0;
+        const double g0 = b1 - a1 * b0, g1 = b2 - a2 * b0;
+
+        for (int pass = 4 * jmax (0, numStages); --pass >= 0;)
+        {
+            // Signal after this pass, from the state before it and the signal into it
+            const double nextC[2] = { A[0][0] + b0 * c[0], A[0][1] + b0 * c[1] };
+            const double nextD = b[0] + b0 * d;
+
+            // State after this pass: v1' = -a1 v1 + v2 + g0 u, v2' = -a2 v1 + g1 u
+            const double nextA[2][2] = { { -a1 * A[0][0] + A[1][0] + g0 * c[0], -a1 * A[0][1] + A[1][1] + g0 * c[1] },
+                                         { -a2 * A[0][0] + g1 * c[0],           -a2 * A[0][1] + g1 * c[1] } };
+            const double nextB[2] = { -a1 * b[0] + b[1] + g0 * d, -a2 * b[0] + g1 * d };
+
+            for (int i = 0; i < 2; ++i)
+            {
+                c[i] = nextC[i];
+                b[i] = nextB[i];
+                A[i][0] = nextA[i][0];
+                A[i][1] = nextA[i][1];
+            }
+
+            d = nextD;
+        }
+    }
+
+    // W = d + (n1 z^-1 + n0 z^-2) / D, D = 1 - tr z^-1 + det z^-2, with n1 z + n0 = c adj(zI - A) b
+    const float trace = (float) (A[0][0] + A[1][1]);
+    const float determinant = (float) (A[0][0] * A[1][1] - A[0][1] * A[1][0]);
+    const float n1 = (float) (c[0] * b[0] + c[1] * b[1]);
+    const float n0 = (float) (A[0][1] * c[0] * b[1] + A[1][0] * c[1] * b[0]
+                               - A[1][1] * c[0] * b[0] - A[0][0] * c[1] * b[1]);
+
+    // Dry plus wet, 1 + mix W, in real/imag
+    {
+        const float m = mix, wetDirect = (float) d;
+        float* const hr = real.get();
+        float* const hi = imag.get();
+
+        for (int i = 0; i < n; ++i)
+        {
+            const float dr = 1.0f - trace * cos1[i] + determinant * cos2[i];
+            const float di = trace * sin1[i] - determinant * sin2[i];
+            const float nr = n1 * cos1[i] + n0 * cos2[i];
+            const float ni = -(n1 * sin1[i] + n0 * sin2[i]);
+            const float scale = 1.0f / (dr * dr + di * di);
+
+            // N / D = N conj(D) / |D|^2
+            hr[i] = 1.0f + m * (wetDirect + (nr * dr + ni * di) * scale);
+            hi[i] = m * (ni * dr - nr * di) * scale;
+        }
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        decibels[i] = 10.0f * std::log10 (real[i] * real[i] + imag[i] * imag[i] + 1.0e-12f);
+        phases[i] = std::atan2 (imag[i], real[i]);
+    }
+
+    // Notches are the minima below the dry level, placed between bins by
+    // fitting a parabola through the neighbours
+    for (int i = 1; i < n - 1; ++i)
+    {
+        if (decibels[i] < -0.1f && decibels[i] < decibels[i - 1] && decibels[i] <= decibels[i + 1])
+        {
+            const float left = decibels[i - 1], centre = decibels[i], right = decibels[i + 1];
+            const float curvature = left - 2.0f * centre + right;
+            const float offset = curvature > 0.0f ? jlimit (-0.5f, 0.5f, 0.5f * (left - right) / curvature) : 0.0f;
+            const int neighbour = offset < 0.0f ? i - 1 : i + 1;
+
+            notches.add (frequencies[i] * std::pow (frequencies[neighbour] / frequencies[i], std::abs (offset)));
+        }
+    }
+
+    const float height = (float) getHeight();
+
+    for (int i = 0; i < n; ++i)
+    {
+        const float x = (float) i + 0.5f;
+        const float yMagnitude = jmap (jlimit (minDecibels, maxDecibels, decibels[i]), minDecibels, maxDecibels, height, 0.0f);
+        const float yPhase = jmap (phases[i], -float_Pi, float_Pi, height, 0.0f);
+
+        if (i == 0)
+        {
+            magnitudePath.startNewSubPath (x, yMagnitude);
+            phasePath.startNewSubPath (x, yPhase);
+        }
+        else
+        {
+            magnitudePath.lineTo (x, yMagnitude);
+            phasePath.lineTo (x, yPhase);
+        }
+    }
+}
+
+void ResponseDisplay::paint (Graphics& g)
+{
+    g.fillAll (Colours::black);
+
+    const float height = (float) getHeight();
+    const float unity = jmap (0.0f, minDecibels, maxDecibels, height, 0.0f);
+
+    g.setColour (Colours::darkgrey);
+    g.drawHorizontalLine (roundToInt (unity), 0.0f, (float) getWidth());
+
+    if (numBins > 1)
+    {
+        const float logRange = std::log (frequencies[numBins - 1] / frequencies[0]);
+
+        g.setColour (Colours::red.withAlpha (0.6f));
+
+        for (auto f : notches)
+        {
+            const float x = 0.5f + (numBins - 1) * std::log (f / frequencies[0]) / logRange;
+            g.drawVerticalLine (roundToInt (x), 0.0f, height);
+        }
+    }
+
+    g.setColour (Colours::grey);
+    g.strokePath (phasePath, PathStrokeType (1.0f));
+
+    g.setColour (Colours::cyan);
+    g.strokePath (magnitudePath, PathStrokeType (1.5f));
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    ResponseDisplay.h
+    Author:  eric carmi
+
+    The magnitude and phase response of the phaser as it stands, with its
+    notches marked, worked out from the cascade coefficients rather than
+    measured.
+
+    The engine doesn't run a chain of separate allpasses. Each channel has one
+    biquad, (z2 + Re z^-1 + z^-2) / (1 + Re z^-1 + z2 z^-2) in direct form II
+    transposed, and every sample passes through it 4 * stages times over the
+    same two state variables. Within a sample those passes are linear in the
+    state and the input, so together they make a single system with two
+    states:
+
+        s[n+1] = A s[n] + b x[n],   y[n] = c s[n] + d x[n]
+
+    Composing the passes gives A, b, c and d, and the wet response
+    c (zI - A)^-1 b + d works out to one biquad again,
+
+        W(z) = d + (n1 z^-1 + n0 z^-2) / (1 - tr(A) z^-1 + det(A) z^-2)
+
+    The output is then 1 + mix W. This is not an allpass, and it is not the
+    single section's response raised to the power 4 * stages.
+
+    There's one frequency bin per pixel column, log spaced from 20 Hz, and
+    the cos and sin terms of each bin are worked out once per size and sample
+    rate. W is then evaluated over all the bins at once, a plain loop over
+    arrays with no branches that the compiler vectorises; only the final
+    log10 and atan2 are per bin.
+
+    The editor feeds it the coefficients from its telemetry records on its
+    refresh clock, so nothing here runs on the audio thread or faster than
+    the screen. Nothing is evaluated or repainted unless they changed.
+
+  ==============================================================================
+*/
+
+#ifndef RESPONSEDISPLAY_H_INCLUDED
+#define RESPONSEDISPLAY_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+class ResponseDisplay  : public Component
+{
+public:
+    ResponseDisplay();
+    ~ResponseDisplay();
+
+    // Returns true if anything changed and a repaint is on its way
+    bool setCoefficients (float allpassRe, float allpassZ2, int stages, float mix, double sampleRate);
+
+    // Notch frequencies in Hz from the last evaluation, lowest first
+    const Array<float>& getNotches() const noexcept     { return notches; }
+
+    void paint (Graphics& g) override;
+    void resized() override;
+
+private:
+    void prepareBins();
+    void evaluate();
+
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f;
+    static constexpr float minDecibels = -36.0f, maxDecibels = 6.0f;
+
+    float re = 0.0f, z2 = 0.0f, mix = 0.0f;
+    int numStages = 0;
+    double sampleRate = 0.0;
+    bool needsEvaluating = true;
+
+    // Per bin, one for each pixel column
+    int numBins = 0;
+    HeapBlock<float> frequencies, cos1, sin1, cos2, sin2;
+    HeapBlock<float> real, imag;
+    HeapBlock<float> decibels, phases;
+
+    Array<float> notches;
+    Path magnitudePath, phasePath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseDisplay)
+};
+
+#endif  // RESPONSEDISPLAY_H_INCLUDED
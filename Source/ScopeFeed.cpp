@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    ScopeFeed.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "ScopeFeed.h"
+
+ScopeFeed::ScopeFeed()
+    : fifo (capacity + 1),      // an AbstractFifo holds one less than its size
+      points ((size_t) capacity + 1)
+{
+}
+
+void ScopeFeed::push (const float* osc) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+    {
+        numDropped.store (numDropped.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+
+    Point& p = points[size1 > 0 ? start1 : start2];
+    p.x = osc[0];
+    p.y = osc[1];
+    p.z = osc[2];
+
+    fifo.finishedWrite (1);
+}
+
+int ScopeFeed::read (Point* dest, int maxPoints) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (maxPoints, start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        dest[i] = points[start1 + i];
+
+    for (int i = 0; i < size2; ++i)
+        dest[size1 + i] = points[start2 + i];
+
+    fifo.finishedRead (size1 + size2);
+    return size1 + size2;
+}
+
+void ScopeFeed::skipToEnd() noexcept
+{
+    fifo.finishedRead (fifo.getNumReady());
+}
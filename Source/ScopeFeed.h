@@ -0,0 +1,59 @@
+/*
+  ==============================================================================
+
+    ScopeFeed.h
+    Author:  eric carmi
+
+    The LFO's outputs, osc[0..2], decimated to about pointsPerSecond, from the
+    audio thread to the editor's scope.
+
+    A single producer, single consumer AbstractFifo: the engine pushes a point
+    every few samples and the editor takes them on its refresh clock. Neither
+    side waits for the other. When the editor isn't reading, the feed fills up
+    and further points are dropped, which costs the audio thread one check.
+
+  ==============================================================================
+*/
+
+#ifndef SCOPEFEED_H_INCLUDED
+#define SCOPEFEED_H_INCLUDED
+
+#include "DspHeader.h"
+#include <atomic>
+
+class ScopeFeed
+{
+public:
+    enum
+    {
+        capacity = 4096,
+        pointsPerSecond = 1000
+    };
+
+    struct Point
+    {
+        float x, y, z;
+    };
+
+    ScopeFeed();
+
+    // Audio thread, wait-free
+    void push (const float* osc) noexcept;
+
+    // The one reader: copies up to maxPoints, oldest first
+    int read (Point* dest, int maxPoints) noexcept;
+
+    // The one reader: drops everything not read yet
+    void skipToEnd() noexcept;
+
+    uint32 getNumDropped() const noexcept       { return numDropped.load (std::memory_order_relaxed); }
+
+private:
+    AbstractFifo fifo;
+    HeapBlock<Point> points;
+    std::atomic<uint32> numDropped { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (ScopeFeed)
+};
+
+#endif  // SCOPEFEED_H_INCLUDED
@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    Telemetry.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "Telemetry.h"
+
+TelemetryStream::TelemetryStream()
+{
+    static_assert ((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+
+    for (auto& slot : slots)
+    {
+        slot.sequence.store (0, std::memory_order_relaxed);
+        zerostruct (slot.record);
+    }
+}
+
+// A slot's sequence is odd while it is being written, and 2 * (index + 1)
+// once record number index is complete
+void TelemetryStream::push (const TelemetryRecord& record) noexcept
+{
+    const uint64 index = writeIndex.load (std::memory_order_relaxed);
+    Slot& slot = slots[index & (capacity - 1)];
+
+    slot.sequence.store (2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    slot.record = record;
+
+    slot.sequence.store (2 * index + 2, std::memory_order_release);
+    writeIndex.store (index + 1, std::memory_order_release);
+}
+
+int TelemetryStream::read (Reader& reader, TelemetryRecord* dest, int maxRecords) const noexcept
+{
+    const uint64 end = writeIndex.load (std::memory_order_acquire);
+
+    if (end - reader.nextIndex > (uint64) capacity)
+    {
+        reader.numDropped += end - capacity - reader.nextIndex;
+        reader.nextIndex = end - capacity;
+    }
+
+    int numRead = 0;
+
+    while (reader.nextIndex < end && numRead < maxRecords)
+    {
+        const Slot& slot = slots[reader.nextIndex & (capacity - 1)];
+        const uint64 expected = 2 * reader.nextIndex + 2;
+
+        const uint64 before = slot.sequence.load (std::memory_order_acquire);
+        dest[numRead] = slot.record;
+        std::atomic_thread_fence (std::memory_order_acquire);
+        const uint64 after = slot.sequence.load (std::memory_order_relaxed);
+
+        // If the writer lapped us while copying, the record is gone
+        if (before == expected && after == expected)
+            ++numRead;
+        else
+            ++reader.numDropped;
+
+        ++reader.nextIndex;
+    }
+
+    return numRead;
+}
+
+void TelemetryStream::skipToEnd (Reader& reader) const noexcept
+{
+    reader.nextIndex = writeIndex.load (std::memory_order_acquire);
+}
+
+//==============================================================================
+TelemetryFileLogger::TelemetryFileLogger (const TelemetryStream& s, const File& file)
+    : Thread ("Phazer telemetry logger"),
+      stream (s)
+{
+    file.deleteFile();
+    output = file.createOutputStream();
+
+    if (output != nullptr)
+    {
+        *output << "block,events,lfo,notch_hz,block_us,budget_us" << newLine;
+        stream.skipToEnd (reader);
+        startThread (2);
+    }
+}
+
+TelemetryFileLogger::~TelemetryFileLogger()
+{
+    stopThread (1000);
+
+    if (output != nullptr)
+    {
+        writePending();
+
+        if (reader.numDropped > 0)
+            *output << "# dropped " << (int64) reader.numDropped << " records" << newLine;
+    }
+}
+
+void TelemetryFileLogger::run()
+{
+    while (! threadShouldExit())
+    {
+        writePending();
+        wait (100);
+    }
+}
+
+void TelemetryFileLogger::writePending()
+{
+    TelemetryRecord records[64];
+    int numRead;
+
+    while ((numRead = stream.read (reader, records, numElementsInArray (records))) > 0)
+    {
+        for (int i = 0; i < numRead; ++i)
+        {
+            const TelemetryRecord& r = records[i];
+            *output << (int64) r.blockNumber << ',' << (int) r.events << ','
+                    << r.lfo << ',' << r.notchFreq << ','
+                    << r.blockMicros << ',' << r.budgetMicros << newLine;
+        }
+    }
+
+    output->flush();
+}
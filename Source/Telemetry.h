@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    Telemetry.h
+    Author:  eric carmi
+
+    One record per processed block, written by the audio thread and read by
+    the editor or a file logger.
+
+    The stream is a ring of slots guarded by per-slot sequence numbers. The
+    writer never waits: it simply overwrites the oldest slot. Every reader keeps
+    its own cursor, so any number of them can follow the stream without locks;
+    a reader that falls behind skips the records that were overwritten and
+    counts them as dropped.
+
+  ==============================================================================
+*/
+
+#ifndef TELEMETRY_H_INCLUDED
+#define TELEMETRY_H_INCLUDED
+
+#include "DspHeader.h"
+#include <atomic>
+
+struct TelemetryRecord
+{
+    // Watchdog events, OR'd together in events
+    enum Events
+    {
+        overBudget      = 1 << 0,   // the block took longer than its real-time duration
+        nonFiniteLfo    = 1 << 1,   // the oscillator produced inf or NaN
+        nonFiniteOutput = 1 << 2    // the filters produced inf or NaN
+    };
+
+    uint32 blockNumber;
+    uint32 events;
+    float lfo;              // last LFO value of the block
+    float notchFreq;        // centre frequency of the allpass sections in Hz, this sets the notches
+    float blockMicros;      // time spent in processBlock
+    float budgetMicros;     // real-time duration of the block
+
+    // The cascade as it stood at the end of the block, enough to work out its response:
+    // each sample passes 4 * stages times through the same biquad,
+    // (z2 + Re z^-1 + z^-2) / (1 + Re z^-1 + z2 z^-2), over one shared state, and
+    // the output is the input plus mix times that. See ResponseDisplay.h for what
+    // this works out to. Mix is 0 while the effect is off.
+    float allpassRe;
+    float allpassZ2;
+    float mix;
+    int32 stages;
+};
+
+//==============================================================================
+class TelemetryStream
+{
+public:
+    enum { capacity = 512 };    // must be a power of two
+
+    TelemetryStream();
+
+    // Audio thread only, wait-free
+    void push (const TelemetryRecord& record) noexcept;
+
+    struct Reader
+    {
+        uint64 nextIndex = 0;
+        uint64 numDropped = 0;
+    };
+
+    // Copies up to maxRecords of the records the reader hasn't seen yet, oldest first.
+    // Any thread, never blocks the writer.
+    int read (Reader& reader, TelemetryRecord* dest, int maxRecords) const noexcept;
+
+    // Moves a reader to the current end of the stream
+    void skipToEnd (Reader& reader) const noexcept;
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64> sequence;
+        TelemetryRecord record;
+    };
+
+    Slot slots[capacity];
+    std::atomic<uint64> writeIndex { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (TelemetryStream)
+};
+
+//==============================================================================
+// Appends the stream to a CSV file from a background thread
+class TelemetryFileLogger  : private Thread
+{
+public:
+    TelemetryFileLogger (const TelemetryStream& stream, const File& file);
+    ~TelemetryFileLogger();
+
+    bool openedOk() const               { return output != nullptr; }
+
+private:
+    void run() override;
+    void writePending();
+
+    const TelemetryStream& stream;
+    TelemetryStream::Reader reader;
+    ScopedPointer<FileOutputStream> output;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TelemetryFileLogger)
+};
+
+#endif  // TELEMETRY_H_INCLUDED
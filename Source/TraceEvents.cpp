@@ -0,0 +1,190 @@
+/*
+  ==============================================================================
+
+    TraceEvents.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "TraceEvents.h"
+
+#if PHAZER_TRACE
+
+#include <atomic>
+
+#if JUCE_INTEL && JUCE_MSVC
+ #include <intrin.h>
+#elif JUCE_INTEL
+ #include <x86intrin.h>
+#endif
+
+namespace TraceEvents
+{
+    namespace
+    {
+        struct Event
+        {
+            uint64 start;
+            uint32 duration;
+            uint16 phase;
+            uint16 numSamples;
+        };
+
+        struct Ring
+        {
+            Event events[eventsPerThread];
+            std::atomic<uint64> writeIndex { 0 };
+        };
+
+        const char* const phaseNames[numPhases] =
+        {
+            "process", "parameterRead", "lfo", "coefficients", "cascade", "crossfade", "bufferCopy", "oversampling"
+        };
+
+        Ring rings[maxThreads];
+        std::atomic<int> numRingsClaimed { 0 };
+
+        thread_local Ring* threadRing = nullptr;
+        thread_local bool hasClaimedRing = false;
+
+        // Time stamps are converted to microseconds against the high resolution
+        // counter, over the whole time since startup
+        const uint64 originStamp = now();
+        const int64 originTicks = Time::getHighResolutionTicks();
+
+        Ring* getThreadRing() noexcept
+        {
+            if (! hasClaimedRing)
+            {
+                hasClaimedRing = true;
+                const int index = numRingsClaimed.fetch_add (1);
+
+                if (index < maxThreads)
+                    threadRing = rings + index;
+            }
+
+            return threadRing;
+        }
+
+        int getNumRings() noexcept
+        {
+            return jmin ((int) maxThreads, numRingsClaimed.load());
+        }
+    }
+
+    uint64 now() noexcept
+    {
+       #if JUCE_INTEL
+        return (uint64) __rdtsc();
+       #else
+        return (uint64) Time::getHighResolutionTicks();
+       #endif
+    }
+
+    void record (Phase phase, uint64 start, uint64 end, uint32 numSamples) noexcept
+    {
+        if (Ring* ring = getThreadRing())
+        {
+            const uint64 index = ring->writeIndex.load (std::memory_order_relaxed);
+            Event& e = ring->events[index & (eventsPerThread - 1)];
+
+            e.start = start;
+            e.duration = (uint32) jmin (end - start, (uint64) 0xffffffff);
+            e.phase = (uint16) phase;
+            e.numSamples = (uint16) jmin (numSamples, (uint32) 0xffff);
+
+            ring->writeIndex.store (index + 1, std::memory_order_release);
+        }
+    }
+
+    String toChromeJson()
+    {
+        // A short calibration gives a poor rate, so wait if the process has only just started
+        if (Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - originTicks) < 0.05)
+            Thread::sleep (50);
+
+        const uint64 stamp = now();
+        const double seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - originTicks);
+        const double stampsPerMicrosecond = (double) (stamp - originStamp) / (1.0e6 * seconds);
+
+        MemoryOutputStream out;
+        out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n"
+            << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Phazer\"}}";
+
+        HeapBlock<Event> copy (eventsPerThread);
+
+        for (int r = 0; r < getNumRings(); ++r)
+        {
+            const Ring& ring = rings[r];
+            const uint64 end = ring.writeIndex.load (std::memory_order_acquire);
+            const uint64 begin = end > eventsPerThread ? end - eventsPerThread : 0;
+
+            for (uint64 i = begin; i < end; ++i)
+                copy[(int) (i - begin)] = ring.events[i & (eventsPerThread - 1)];
+
+            // The writer may have carried on meanwhile, the slot it was writing
+            // and every one it finished since hold newer events
+            const uint64 endAfterCopy = ring.writeIndex.load (std::memory_order_acquire);
+            const uint64 firstIntact = endAfterCopy >= eventsPerThread ? endAfterCopy - eventsPerThread + 1 : 0;
+
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r
+                << ",\"args\":{\"name\":\"thread " << r << "\"}}";
+
+            for (uint64 i = jmax (begin, firstIntact); i < end; ++i)
+            {
+                const Event& e = copy[(int) (i - begin)];
+
+                out << ",\n{\"name\":\"" << phaseNames[e.phase] << "\",\"cat\":\"phazer\",\"ph\":\"X\",\"pid\":1,\"tid\":" << r
+                    << ",\"ts\":" << String ((double) (e.start - originStamp) / stampsPerMicrosecond, 3)
+                    << ",\"dur\":" << String (e.duration / stampsPerMicrosecond, 3);
+
+                if (e.numSamples > 0)
+                    out << ",\"args\":{\"samples\":" << (int) e.numSamples << "}";
+
+                out << "}";
+            }
+        }
+
+        out << "\n]}\n";
+        return out.toUTF8();
+    }
+
+    bool writeChromeJson (const File& file)
+    {
+        return file.replaceWithText (toChromeJson());
+    }
+
+    void clear()
+    {
+        for (int r = 0; r < getNumRings(); ++r)
+            rings[r].writeIndex.store (0);
+    }
+
+    //==============================================================================
+    Splitter::Splitter() noexcept
+        : start (now()), last (start)
+    {
+        for (int i = 0; i < numPhases; ++i)
+        {
+            totals[i] = 0;
+            counts[i] = 0;
+        }
+    }
+
+    Splitter::~Splitter() noexcept
+    {
+        uint64 t = start;
+
+        for (int i = 0; i < numPhases; ++i)
+        {
+            if (counts[i] > 0)
+            {
+                record ((Phase) i, t, t + totals[i], counts[i]);
+                t += totals[i];
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    TraceEvents.h
+    Author:  eric carmi
+
+    Timing markers around the phases of a block, exported as Chrome trace
+    event JSON (load it in chrome://tracing or ui.perfetto.dev).
+
+    Only built when PHAZER_TRACE is 1, e.g.
+
+        make CONFIG=Release CPPFLAGS=-DPHAZER_TRACE=1
+
+    Otherwise the macros below expand to nothing and nothing here exists.
+
+    PHAZER_TRACE_SCOPE (phase) times the rest of the enclosing scope. The
+    per-sample phases are too short to record one event each, so a splitter
+    instead adds the time since its previous split to the phase named by the
+    current one, and when it goes out of scope writes one event per phase
+    with the total. Those events are laid end to end from the splitter's
+    start, so in the viewer the loop is divided in proportion to where its
+    time went, and each carries the number of samples it covers.
+
+    Each thread that records gets one of a fixed set of rings on its first
+    event, nothing is allocated. A ring keeps the thread's most recent events
+    and has a single writer, so a marker is two reads of the time stamp
+    counter and a store, a few nanoseconds. Threads beyond maxThreads aren't
+    recorded.
+
+  ==============================================================================
+*/
+
+#ifndef TRACEEVENTS_H_INCLUDED
+#define TRACEEVENTS_H_INCLUDED
+
+#ifndef PHAZER_TRACE
+ #define PHAZER_TRACE 0
+#endif
+
+#if PHAZER_TRACE
+
+#include "DspHeader.h"
+
+namespace TraceEvents
+{
+    enum Phase
+    {
+        process,            // PhazerEngine::process() as a whole
+        parameterRead,      // parameters, programs and morph into PhazerParameters and the smoothers
+        lfo,
+        coefficients,
+        cascade,
+        crossfade,
+        bufferCopy,
+        oversampling,       // up and down through the half-band filters
+        numPhases
+    };
+
+    enum
+    {
+        maxThreads = 16,
+        eventsPerThread = 16384     // must be a power of two
+    };
+
+    // Raw time stamp, rdtsc on x86 and the high resolution counter elsewhere
+    uint64 now() noexcept;
+
+    // Adds an event to the calling thread's ring
+    void record (Phase phase, uint64 start, uint64 end, uint32 numSamples = 0) noexcept;
+
+    // Every ring's events, oldest first, as a Chrome trace. Any thread; events
+    // being overwritten while it runs are left out.
+    String toChromeJson();
+    bool writeChromeJson (const File& file);
+
+    // Empties the rings. Nothing may be recording at the time.
+    void clear();
+
+    //==============================================================================
+    struct Scope
+    {
+        Scope (Phase p) noexcept  : phase (p), start (now())    {}
+        ~Scope() noexcept                                       { record (phase, start, now()); }
+
+        const Phase phase;
+        const uint64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (Scope)
+    };
+
+    struct Splitter
+    {
+        Splitter() noexcept;
+        ~Splitter() noexcept;
+
+        void split (Phase phase) noexcept
+        {
+            const uint64 t = now();
+            totals[phase] += t - last;
+            ++counts[phase];
+            last = t;
+        }
+
+        uint64 start, last;
+        uint64 totals[numPhases];
+        uint32 counts[numPhases];
+
+        JUCE_DECLARE_NON_COPYABLE (Splitter)
+    };
+}
+
+ #define PHAZER_TRACE_SCOPE(phase)              const TraceEvents::Scope JUCE_JOIN_MACRO (traceScope, __LINE__) (TraceEvents::phase)
+ #define PHAZER_TRACE_SPLITTER(name)            TraceEvents::Splitter name
+ #define PHAZER_TRACE_SPLIT(splitter, phase)    splitter.split (TraceEvents::phase)
+#else
+ #define PHAZER_TRACE_SCOPE(phase)
+ #define PHAZER_TRACE_SPLITTER(name)
+ #define PHAZER_TRACE_SPLIT(splitter, phase)
+#endif
+
+#endif  // TRACEEVENTS_H_INCLUDED
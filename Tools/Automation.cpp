@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    Automation.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "Automation.h"
+#include <algorithm>
+
+static const char* const parameterNames[] = { "rate", "depth", "width", "freq", "mix", "stages" };
+
+String Automation::load (const File& file)
+{
+    breakpoints.clearQuick();
+
+    if (! file.existsAsFile())
+        return "can't open automation " + file.getFullPathName();
+
+    MemoryMappedFile mapped (file, MemoryMappedFile::readOnly);
+    FileHeader header = {};
+
+    if (mapped.getData() != nullptr && mapped.getSize() >= sizeof (FileHeader))
+        memcpy (&header, mapped.getData(), sizeof (FileHeader));
+
+    return header.magicNumber == (uint32) magic ? loadBinary (mapped) : loadCsv (file);
+}
+
+String Automation::loadBinary (const MemoryMappedFile& mapped)
+{
+    FileHeader header;
+    memcpy (&header, mapped.getData(), sizeof (FileHeader));
+
+    if ((mapped.getSize() - sizeof (FileHeader)) / sizeof (Breakpoint) < header.numBreakpoints)
+        return "automation file is truncated";
+
+    const char* records = static_cast<const char*> (mapped.getData()) + sizeof (FileHeader);
+    breakpoints.resize ((int) header.numBreakpoints);
+    memcpy (breakpoints.getRawDataPointer(), records, header.numBreakpoints * sizeof (Breakpoint));
+
+    for (auto& b : breakpoints)
+        if (b.parameter >= (uint32) numParameters || ! (b.time >= 0.0))
+            return "bad breakpoint in automation file";
+
+    return {};
+}
+
+String Automation::loadCsv (const File& file)
+{
+    StringArray lines;
+    file.readLines (lines);
+
+    for (int lineNumber = 0; lineNumber < lines.size(); ++lineNumber)
+    {
+        const String line (lines[lineNumber].upToFirstOccurrenceOf ("#", false, false).trim());
+
+        if (line.isEmpty())
+            continue;
+
+        StringArray fields (StringArray::fromTokens (line, ",", ""));
+        fields.trim();
+
+        const String error (file.getFileName() + ":" + String (lineNumber + 1) + ": ");
+
+        if (fields.size() != 3)
+            return error + "expected time, parameter, value";
+
+        Breakpoint b;
+        b.time = fields[0].getDoubleValue();
+        b.parameter = (uint32) numParameters;
+        b.value = fields[2].getFloatValue();
+
+        for (int i = 0; i < numParameters; ++i)
+            if (fields[1].equalsIgnoreCase (parameterNames[i]))
+                b.parameter = (uint32) i;
+
+        if (b.parameter == (uint32) numParameters)
+            return error + "unknown parameter " + fields[1];
+
+        if (b.time < 0.0 || ! fields[0].containsOnly ("0123456789.eE+-") || ! fields[2].containsOnly ("0123456789.eE+-"))
+            return error + "bad number";
+
+        breakpoints.add (b);
+    }
+
+    return {};
+}
+
+bool Automation::saveBinary (const File& file) const
+{
+    FileHeader header;
+    header.magicNumber = magic;
+    header.version = currentVersion;
+    header.numBreakpoints = (uint32) breakpoints.size();
+    header.reserved = 0;
+
+    MemoryBlock data (&header, sizeof (FileHeader));
+    data.append (breakpoints.begin(), (size_t) breakpoints.size() * sizeof (Breakpoint));
+
+    return file.replaceWithData (data.getData(), data.getSize());
+}
+
+//==============================================================================
+void Automation::prepare (double sampleRate)
+{
+    for (auto& p : points)
+        p.clearQuick();
+
+    for (auto& b : breakpoints)
+        points[b.parameter].add ({ (int64) std::llround (b.time * sampleRate), (double) b.value });
+
+    // Breakpoints at the same time keep their file order, the last one wins
+    for (auto& p : points)
+        std::stable_sort (p.begin(), p.end(), [] (const Point& a, const Point& b) { return a.sample < b.sample; });
+}
+
+int64 Automation::getNextBreakpoint (int64 position, int64 limit) const
+{
+    for (auto& p : points)
+    {
+        auto next = std::upper_bound (p.begin(), p.end(), position,
+                                      [] (int64 sample, const Point& point) { return sample < point.sample; });
+
+        if (next != p.end())
+            limit = jmin (limit, next->sample);
+    }
+
+    return limit;
+}
+
+// The line through the breakpoints either side of segmentStart, at sample
+double Automation::getValue (int parameter, int64 sample, int64 segmentStart) const
+{
+    const Array<Point>& p = points[parameter];
+
+    auto next = std::upper_bound (p.begin(), p.end(), segmentStart,
+                                  [] (int64 s, const Point& point) { return s < point.sample; });
+
+    if (next == p.begin())
+        return p.getFirst().value;
+
+    const Point& a = *(next - 1);
+
+    if (next == p.end() || parameter == stages)
+        return a.value;
+
+    const Point& b = *next;
+    return a.value + (b.value - a.value) * (double) (sample - a.sample) / (double) (b.sample - a.sample);
+}
+
+void Automation::getRamp (int64 start, int64 end, const PhazerParameters& base,
+                          PhazerParameters& from, PhazerParameters& to) const
+{
+    jassert (getNextBreakpoint (start, end) == end);
+
+    from = base;
+    to = base;
+
+    float* fromValues[] = { &from.rate, &from.depth, &from.width, &from.centerfreq, &from.mix };
+    float* toValues[] = { &to.rate, &to.depth, &to.width, &to.centerfreq, &to.mix };
+
+    for (int i = rate; i <= mix; ++i)
+    {
+        if (points[i].isEmpty())
+            continue;
+
+        *fromValues[i] = (float) getValue (i, start - 1, start);
+        *toValues[i] = (float) getValue (i, end - 1, start);
+    }
+
+    if (! points[stages].isEmpty())
+        from.stages = to.stages = roundToInt (getValue (stages, start, start));
+
+    from.limit();
+    to.limit();
+}
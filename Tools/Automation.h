@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    Automation.h
+    Author:  eric carmi
+
+    Parameter automation for offline renders, as breakpoints.
+
+    Between two breakpoints a parameter moves in a straight line, before the
+    first and after the last it holds. Stages step at each breakpoint instead
+    of ramping. Times are in seconds and land on the nearest sample.
+
+    A CSV file has one breakpoint per line, '#' starts a comment:
+
+        # time, parameter, value
+        0.0, rate, 0.5
+        4.0, rate, 6
+        4.0, stages, 8
+
+    The binary form is a 16 byte header, magic "PHZA", version, number of
+    breakpoints and a reserved word, followed by 16 byte records: time as a
+    double, parameter index (rate, depth, width, freq, mix, stages) and
+    value as a float, all little-endian. It's read straight out of the
+    memory-mapped file.
+
+  ==============================================================================
+*/
+
+#ifndef AUTOMATION_H_INCLUDED
+#define AUTOMATION_H_INCLUDED
+
+#include "../Source/PhazerEngine.h"
+
+class Automation
+{
+public:
+    enum Parameter
+    {
+        rate, depth, width, freq, mix, stages,
+        numParameters
+    };
+
+    Automation() = default;
+
+    // CSV or binary, whichever the file is. Returns an error message, or an
+    // empty string on success.
+    String load (const File& file);
+
+    bool saveBinary (const File& file) const;
+
+    bool isEmpty() const noexcept                           { return breakpoints.isEmpty(); }
+
+    // Places the breakpoints on samples. Call before the functions below.
+    void prepare (double sampleRate);
+
+    // The first sample after position where any parameter has a breakpoint,
+    // or limit if there's none before it
+    int64 getNextBreakpoint (int64 position, int64 limit) const;
+
+    // The values at the last samples before start and end, for
+    // PhazerEngine::processRamp(). There must be no breakpoint in
+    // (start, end). Parameters without automation come from base.
+    void getRamp (int64 start, int64 end, const PhazerParameters& base,
+                  PhazerParameters& from, PhazerParameters& to) const;
+
+private:
+    struct Breakpoint
+    {
+        double time;
+        uint32 parameter;
+        float value;
+    };
+
+    struct Point
+    {
+        int64 sample;
+        double value;
+    };
+
+    struct FileHeader
+    {
+        uint32 magicNumber, version, numBreakpoints, reserved;
+    };
+
+    enum
+    {
+        magic = 0x415a4850,     // "PHZA" in a little-endian dump
+        currentVersion = 1
+    };
+
+    static_assert (sizeof (Breakpoint) == 16, "the binary file format depends on this layout");
+
+    String loadCsv (const File& file);
+    String loadBinary (const MemoryMappedFile& mapped);
+    double getValue (int parameter, int64 sample, int64 segmentStart) const;
+
+    Array<Breakpoint> breakpoints;
+    Array<Point> points[numParameters];     // sorted by sample
+
+    JUCE_DECLARE_NON_COPYABLE (Automation)
+};
+
+#endif  // AUTOMATION_H_INCLUDED
@@ -0,0 +1,710 @@
+/*
+  ==============================================================================
+
+    Benchmarks.cpp
+    Author:  eric carmi
+
+    Microbenchmarks for the DSP, in nanoseconds per sample.
+
+    Five groups, each over its own matrix:
+
+        oscillator      Oscillators::getNextSample, every type at every sample rate
+        cascade         the allpass cascade on its own, every stage count, mono
+                        and stereo, with the coefficients changing every sample
+                        as they do in the engine
+        processBlock    the whole plugin, mono and stereo, every block size,
+                        sample rate and a few stage counts
+        instances       1 to 1024 stereo plugin instances in one process, each
+                        with its own buffers, processed round robin one block
+                        at a time as a host runs a large session
+        oversampling    the whole plugin, stereo, at 1x, 2x, 4x and 8x, and the
+                        up and down filters alone with the effect off
+
+    Every benchmark runs a few warm-up repetitions that aren't counted, then
+    times each repetition over the same number of samples and reports the
+    min, median, mean, standard deviation and max. The median is the number
+    to compare, min shows what the code can do on a quiet machine and a large
+    spread means the run was disturbed.
+
+    Where the kernel allows it, the timed repetitions are also counted with
+    the hardware performance counters in PerfCounters.h, and cycles,
+    instructions, L1 and LLC misses, branch misses and FP assists are
+    reported per sample next to the times, with IPC. Branch misses point at
+    the oscillator switch, L1 misses at filter state spilled to memory and FP
+    assists at denormals. --no-counters leaves them off, --fp-assist-event
+    takes a raw event code for CPUs without the default one.
+
+    A single instance keeps its whole working set in cache, so the instances
+    group shows what's left once they evict each other: the time per sample
+    and per instance block, the load as a share of one core's real time, and
+    with the counters how the cache misses per sample grow.
+
+    It starts with the memory footprint of one plugin instance and how many
+    cache lines the engine's per-sample state takes, see PhazerEngine.h.
+
+    --json writes the results with the build and machine details, so two
+    builds can be diffed over the same matrix.
+
+    Usage: Benchmarks [--quick] [--group name] [--json file] [--repetitions n]
+                      [--warmup n] [--samples n] [--rates 44100,48000]
+                      [--blocks 64,512] [--stages 4,16] [--instances 1,64]
+                      [--no-counters] [--fp-assist-event 0x1eca]
+
+  ==============================================================================
+*/
+
+#include "../Source/PluginProcessor.h"
+#include "PerfCounters.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+extern AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    struct Settings
+    {
+        Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        Array<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048 };
+        Array<int> stageCounts { 1, 4, 8, 16 };     // for processBlock, the cascade runs 1 to 16
+        Array<int> instanceCounts { 1, 8, 64, 256, 1024 };
+        int instanceBlockSize = 512;
+        int instanceStages = 4;
+        int warmup = 3;
+        int repetitions = 15;
+        int samplesPerRepetition = 65536;
+        String group;                               // empty runs all of them
+        File jsonFile;
+        PerfCounters* counters = nullptr;           // null when they're off
+    };
+
+    const char* oscillatorNames[] = { "Sine", "Triangle", "Square", "Saw", "AASquare", "AASaw",
+                                      "Vanderpol", "Duffing", "Chua", "Lorenz" };
+
+    // Stops the compiler from throwing away a loop whose result isn't used
+    volatile float sink = 0.0f;
+
+    Array<double> parseDoubles (const String& list)
+    {
+        Array<double> values;
+        for (auto& token : StringArray::fromTokens (list, ",", ""))
+            values.add (token.getDoubleValue());
+        return values;
+    }
+
+    Array<int> parseInts (const String& list)
+    {
+        Array<int> values;
+        for (auto& token : StringArray::fromTokens (list, ",", ""))
+            values.add (token.getIntValue());
+        return values;
+    }
+
+    //==============================================================================
+    struct Summary
+    {
+        double min, median, mean, stddev, max;      // nanoseconds per sample
+
+        // Hardware counters per sample over all the timed repetitions,
+        // negative when the counter isn't available
+        double perSample[PerfCounters::numCounters];
+    };
+
+    // Calls run, which must process numSamples samples, warmup + repetitions times
+    template <typename RunFunction>
+    Summary measure (const Settings& settings, int numSamples, RunFunction&& run)
+    {
+        for (int i = 0; i < settings.warmup; ++i)
+            run();
+
+        std::vector<double> times;
+        PerfCounters* counters = settings.counters;
+
+        if (counters != nullptr)
+            counters->start();
+
+        for (int i = 0; i < settings.repetitions; ++i)
+        {
+            const int64 start = Time::getHighResolutionTicks();
+            run();
+            const double seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            times.push_back (1.0e9 * seconds / numSamples);
+        }
+
+        Summary s;
+
+        if (counters != nullptr)
+            counters->stop();
+
+        for (int i = 0; i < PerfCounters::numCounters; ++i)
+            s.perSample[i] = counters != nullptr && counters->isAvailable ((PerfCounters::Counter) i)
+                               ? counters->getValue ((PerfCounters::Counter) i) / ((double) numSamples * settings.repetitions)
+                               : -1.0;
+
+        std::sort (times.begin(), times.end());
+
+        s.min = times.front();
+        s.max = times.back();
+        s.median = times.size() % 2 == 1 ? times[times.size() / 2]
+                                         : 0.5 * (times[times.size() / 2 - 1] + times[times.size() / 2]);
+        s.mean = 0.0;
+
+        for (auto t : times)
+            s.mean += t;
+
+        s.mean /= (double) times.size();
+        s.stddev = 0.0;
+
+        for (auto t : times)
+            s.stddev += (t - s.mean) * (t - s.mean);
+
+        s.stddev = std::sqrt (s.stddev / (double) jmax ((size_t) 1, times.size() - 1));
+        return s;
+    }
+
+    //==============================================================================
+    struct BenchmarkResult
+    {
+        String group, name;
+        int oscType = 0, stages = 0, channels = 0, blockSize = 0, instances = 0, oversampling = 0;
+        double sampleRate = 0.0;
+        Summary nsPerSample;
+    };
+
+    // Time for one instance to process one block
+    double getInstanceBlockMicros (const BenchmarkResult& r)
+    {
+        return 1.0e-3 * r.nsPerSample.median * r.blockSize;
+    }
+
+    // Time for every instance to process a block, over the block's duration
+    double getSessionLoad (const BenchmarkResult& r)
+    {
+        return 1.0e-9 * r.nsPerSample.median * r.instances * r.sampleRate;
+    }
+
+    double getIpc (const Summary& s)
+    {
+        const double cycles = s.perSample[PerfCounters::cycles];
+        const double instructions = s.perSample[PerfCounters::instructions];
+
+        return cycles > 0.0 && instructions >= 0.0 ? instructions / cycles : 0.0;
+    }
+
+    void printResult (const BenchmarkResult& r)
+    {
+        const Summary& s = r.nsPerSample;
+
+        printf ("%-14s %-28s %9.2f ns/sample  (min %.2f, sd %.2f)  %8.2f M samples/s\n",
+                r.group.toRawUTF8(), r.name.toRawUTF8(), s.median, s.min, s.stddev,
+                s.median > 0.0 ? 1.0e3 / s.median : 0.0);
+
+        if (r.instances > 0)
+            printf ("%44s%.2f us per instance block, %.1f%% of one core\n", "",
+                    getInstanceBlockMicros (r), 100.0 * getSessionLoad (r));
+
+        if (s.perSample[PerfCounters::cycles] < 0.0 && s.perSample[PerfCounters::instructions] < 0.0)
+            return;
+
+        const char* labels[PerfCounters::numCounters] = { "cycles", "instr", "L1D", "LLC", "br", "fpa" };
+        String line (String::repeatedString (" ", 44));
+
+        for (int i = 0; i < PerfCounters::numCounters; ++i)
+        {
+            line << labels[i] << " " << (s.perSample[i] < 0.0 ? String ("-") : String (s.perSample[i], i < 2 ? 1 : 4)) << "  ";
+
+            if (i == PerfCounters::instructions)
+                line << "IPC " << String (getIpc (s), 2) << "  ";
+        }
+
+        printf ("%s per sample\n", line.trimEnd().toRawUTF8());
+    }
+
+    void fillNoise (AudioBuffer<float>& buffer, int seed)
+    {
+        Random random (seed);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample (ch, i, random.nextFloat() - 0.5f);
+    }
+
+    //==============================================================================
+    void benchmarkOscillators (const Settings& settings, Array<BenchmarkResult>& results)
+    {
+        for (int type = Oscillators::Sine; type <= Oscillators::Lorenz; ++type)
+        {
+            for (auto sampleRate : settings.sampleRates)
+            {
+                Oscillators oscillator;
+                oscillator.setSampleRate ((float) sampleRate);
+                oscillator.setType (type);
+                oscillator.setFrequency (2.0f);
+
+                float out[3] = { 0.0f, 0.0f, 0.0f };
+
+                BenchmarkResult r;
+                r.group = "oscillator";
+                r.name = String (oscillatorNames[type - 1]) + " @" + String ((int) sampleRate);
+                r.oscType = type;
+                r.sampleRate = sampleRate;
+                r.nsPerSample = measure (settings, settings.samplesPerRepetition, [&]
+                                         {
+                                             float sum = 0.0f;
+
+                                             for (int i = 0; i < settings.samplesPerRepetition; ++i)
+                                             {
+                                                 oscillator.getNextSample (out, 0.0f);
+                                                 sum += out[0];
+                                             }
+
+                                             sink = sum;
+                                         });
+
+                results.add (r);
+                printResult (r);
+            }
+        }
+    }
+
+    // The inner loop of PhazerEngine::mainEffectLoop without the LFO and cos():
+    // new coefficients every sample, then 4 allpass sections per stage
+    void benchmarkCascade (const Settings& settings, Array<BenchmarkResult>& results)
+    {
+        const int tableSize = 1024;
+        HeapBlock<double> Re (tableSize);
+        const double depth = 0.8, z2 = depth * depth;
+
+        for (int i = 0; i < tableSize; ++i)
+            Re[i] = -2.0 * depth * std::cos (2.0 * double_Pi * (1000.0 + 500.0 * std::sin (2.0 * double_Pi * i / tableSize)) / 48000.0);
+
+        for (int channels = 1; channels <= 2; ++channels)
+        {
+            for (int stages = 1; stages <= 16; ++stages)
+            {
+                AudioBuffer<float> input (channels, settings.samplesPerRepetition);
+                fillNoise (input, stages);
+
+                AllpassFilter filters[2];
+
+                BenchmarkResult r;
+                r.group = "cascade";
+                r.name = String (channels == 1 ? "mono" : "stereo") + " " + String (stages) + " stages";
+                r.stages = stages;
+                r.channels = channels;
+                r.nsPerSample = measure (settings, settings.samplesPerRepetition, [&]
+                                         {
+                                             float sum = 0.0f;
+
+                                             for (int i = 0; i < settings.samplesPerRepetition; ++i)
+                                             {
+                                                 const double a = Re[i & (tableSize - 1)];
+                                                 const IIRCoefficients c (z2, a, 1.0, 1.0, a, z2);
+
+                                                 for (int ch = 0; ch < channels; ++ch)
+                                                 {
+                                                     filters[ch].setCoefficients (c);
+                                                     float x = input.getSample (ch, i);
+
+                                                     for (int stage = 0; stage < 4 * stages; ++stage)
+                                                         x = filters[ch].processSingleSampleRaw (x);
+
+                                                     sum += x;
+                                                 }
+                                             }
+
+                                             sink = sum;
+                                         });
+
+                results.add (r);
+                printResult (r);
+            }
+        }
+    }
+
+    void benchmarkProcessBlock (const Settings& settings, Array<BenchmarkResult>& results)
+    {
+        for (int channels = 1; channels <= 2; ++channels)
+        {
+            for (auto sampleRate : settings.sampleRates)
+            {
+                for (auto blockSize : settings.blockSizes)
+                {
+                    for (auto stages : settings.stageCounts)
+                    {
+                        ScopedPointer<PhazerAudioProcessor> processor (static_cast<PhazerAudioProcessor*> (createPluginFilter()));
+                        PhazerAudioProcessor& p = *processor;
+
+                        p.setPlayConfigDetails (channels, channels, sampleRate, blockSize);
+                        p.prepareToPlay (sampleRate, blockSize);
+                        *p.stageParam = stages;
+                        *p.mixParam = 0.5f;
+
+                        // Each block starts from fresh input, as it would in a host,
+                        // so the copy is part of the time
+                        const int numBlocks = jmax (1, settings.samplesPerRepetition / blockSize);
+                        AudioBuffer<float> input (channels, numBlocks * blockSize);
+                        AudioBuffer<float> buffer (channels, blockSize);
+                        MidiBuffer midi;
+                        fillNoise (input, blockSize + stages);
+
+                        BenchmarkResult r;
+                        r.group = "processBlock";
+                        r.name = String (channels == 1 ? "mono" : "stereo") + " " + String (blockSize) + " @"
+                                   + String ((int) sampleRate) + " " + String (stages) + " st";
+                        r.stages = stages;
+                        r.channels = channels;
+                        r.blockSize = blockSize;
+                        r.sampleRate = sampleRate;
+                        r.nsPerSample = measure (settings, numBlocks * blockSize, [&]
+                                                 {
+                                                     for (int b = 0; b < numBlocks; ++b)
+                                                     {
+                                                         for (int ch = 0; ch < channels; ++ch)
+                                                             buffer.copyFrom (ch, 0, input, ch, b * blockSize, blockSize);
+
+                                                         p.processBlock (buffer, midi);
+                                                     }
+                                                 });
+
+                        p.releaseResources();
+                        results.add (r);
+                        printResult (r);
+                    }
+                }
+            }
+        }
+    }
+
+    // Separate processors and buffers, every one fed and processed in turn
+    // each block, as the tracks of a session are
+    void benchmarkInstances (const Settings& settings, Array<BenchmarkResult>& results)
+    {
+        const double sampleRate = settings.sampleRates.getFirst();
+        const int blockSize = settings.instanceBlockSize;
+        const int channels = 2;
+
+        // Each instance reads its own stretch of a shared noise buffer
+        AudioBuffer<float> input (channels, 1 << 16);
+        fillNoise (input, 1);
+        const int numInputBlocks = input.getNumSamples() / blockSize;
+
+        for (auto numInstances : settings.instanceCounts)
+        {
+            OwnedArray<PhazerAudioProcessor> processors;
+            OwnedArray<AudioBuffer<float>> buffers;
+            MidiBuffer midi;
+
+            for (int i = 0; i < numInstances; ++i)
+            {
+                auto* p = processors.add (static_cast<PhazerAudioProcessor*> (createPluginFilter()));
+                p->setPlayConfigDetails (channels, channels, sampleRate, blockSize);
+                p->prepareToPlay (sampleRate, blockSize);
+                *p->stageParam = settings.instanceStages;
+                *p->mixParam = 0.5f;
+                *p->rateParam = 0.1f + 0.01f * (float) (i % 100);
+
+                buffers.add (new AudioBuffer<float> (channels, blockSize));
+            }
+
+            const int numRounds = jmax (1, settings.samplesPerRepetition / (blockSize * numInstances));
+            int round = 0;
+
+            BenchmarkResult r;
+            r.group = "instances";
+            r.name = String (numInstances) + " inst " + String (blockSize) + " @" + String ((int) sampleRate);
+            r.stages = settings.instanceStages;
+            r.channels = channels;
+            r.blockSize = blockSize;
+            r.sampleRate = sampleRate;
+            r.instances = numInstances;
+            r.nsPerSample = measure (settings, numRounds * numInstances * blockSize, [&]
+                                     {
+                                         for (int n = 0; n < numRounds; ++n, ++round)
+                                         {
+                                             for (int i = 0; i < numInstances; ++i)
+                                             {
+                                                 AudioBuffer<float>& buffer = *buffers.getUnchecked (i);
+                                                 const int start = ((round + i) % numInputBlocks) * blockSize;
+
+                                                 for (int ch = 0; ch < channels; ++ch)
+                                                     buffer.copyFrom (ch, 0, input, ch, start, blockSize);
+
+                                                 processors.getUnchecked (i)->processBlock (buffer, midi);
+                                             }
+                                         }
+                                     });
+
+            for (auto* p : processors)
+                p->releaseResources();
+
+            results.add (r);
+            printResult (r);
+        }
+    }
+
+    // One block size, sample rate and stage count at every factor. The cascade's
+    // share goes up with the factor, the filters' cost per host sample stays fixed.
+    void benchmarkOversampling (const Settings& settings, Array<BenchmarkResult>& results)
+    {
+        const double sampleRate = settings.sampleRates.getFirst();
+        const int blockSize = settings.instanceBlockSize;
+        const int channels = 2;
+        const int numBlocks = jmax (1, settings.samplesPerRepetition / blockSize);
+
+        AudioBuffer<float> input (channels, numBlocks * blockSize);
+        AudioBuffer<float> buffer (channels, blockSize);
+        MidiBuffer midi;
+        fillNoise (input, 1);
+
+        for (int power = 1; power >= 0; --power)
+        {
+            for (int factorLog2 = 0; factorLog2 <= Oversampler::maxFactorLog2; ++factorLog2)
+            {
+                ScopedPointer<PhazerAudioProcessor> processor (static_cast<PhazerAudioProcessor*> (createPluginFilter()));
+                PhazerAudioProcessor& p = *processor;
+
+                p.setPlayConfigDetails (channels, channels, sampleRate, blockSize);
+                *p.oversamplingParam = factorLog2;
+                p.prepareToPlay (sampleRate, blockSize);
+                *p.stageParam = settings.instanceStages;
+                *p.mixParam = 0.5f;
+                *p.powerParam = power != 0;
+
+                BenchmarkResult r;
+                r.group = "oversampling";
+                r.name = String (1 << factorLog2) + "x " + String (blockSize) + " @" + String ((int) sampleRate)
+                           + (power != 0 ? " " + String (settings.instanceStages) + " st" : String (" filters"));
+                r.stages = power != 0 ? settings.instanceStages : 0;
+                r.channels = channels;
+                r.blockSize = blockSize;
+                r.sampleRate = sampleRate;
+                r.oversampling = 1 << factorLog2;
+                r.nsPerSample = measure (settings, numBlocks * blockSize, [&]
+                                         {
+                                             for (int b = 0; b < numBlocks; ++b)
+                                             {
+                                                 for (int ch = 0; ch < channels; ++ch)
+                                                     buffer.copyFrom (ch, 0, input, ch, b * blockSize, blockSize);
+
+                                                 p.processBlock (buffer, midi);
+                                             }
+                                         });
+
+                p.releaseResources();
+                results.add (r);
+                printResult (r);
+            }
+        }
+    }
+
+    //==============================================================================
+    struct Footprint
+    {
+        size_t processor, engine, hotState, oscillators, allpassFilter;
+        int hotCacheLines;
+    };
+
+    Footprint getFootprint()
+    {
+        ScopedPointer<PhazerEngine> engine (new PhazerEngine());
+
+        Footprint f;
+        f.processor = sizeof (PhazerAudioProcessor);
+        f.engine = sizeof (PhazerEngine);
+        f.hotState = engine->getHotStateSize();
+        f.oscillators = sizeof (Oscillators);
+        f.allpassFilter = sizeof (AllpassFilter);
+        f.hotCacheLines = (int) ((f.hotState + alignof (PhazerEngine) - 1) / alignof (PhazerEngine));
+        return f;
+    }
+
+    void printFootprint (const Footprint& f)
+    {
+        printf ("footprint: PhazerAudioProcessor %d bytes, PhazerEngine %d bytes\n"
+                "           per-sample state %d bytes in %d cache lines (Oscillators %d, AllpassFilter %d)\n\n",
+                (int) f.processor, (int) f.engine, (int) f.hotState, f.hotCacheLines,
+                (int) f.oscillators, (int) f.allpassFilter);
+    }
+
+    //==============================================================================
+    var toJson (const Settings& settings, const Footprint& footprint, const Array<BenchmarkResult>& results)
+    {
+        auto* build = new DynamicObject();
+        var buildVar (build);
+        build->setProperty ("date", Time::getCurrentTime().toISO8601 (true));
+        build->setProperty ("compiled", String (__DATE__) + " " + String (__TIME__));
+       #if JUCE_DEBUG
+        build->setProperty ("config", "Debug");
+       #else
+        build->setProperty ("config", "Release");
+       #endif
+        build->setProperty ("juce", SystemStats::getJUCEVersion());
+        build->setProperty ("cpu", SystemStats::getCpuModel());
+        build->setProperty ("cpuMHz", SystemStats::getCpuSpeedInMegahertz());
+        build->setProperty ("os", SystemStats::getOperatingSystemName());
+
+        auto* config = new DynamicObject();
+        var configVar (config);
+        config->setProperty ("warmup", settings.warmup);
+        config->setProperty ("repetitions", settings.repetitions);
+        config->setProperty ("samplesPerRepetition", settings.samplesPerRepetition);
+        config->setProperty ("instanceBlockSize", settings.instanceBlockSize);
+        config->setProperty ("counters", settings.counters != nullptr);
+
+        auto* memory = new DynamicObject();
+        var memoryVar (memory);
+        memory->setProperty ("processorBytes", (int) footprint.processor);
+        memory->setProperty ("engineBytes", (int) footprint.engine);
+        memory->setProperty ("hotStateBytes", (int) footprint.hotState);
+        memory->setProperty ("hotCacheLines", footprint.hotCacheLines);
+
+        Array<var> list;
+
+        for (auto& r : results)
+        {
+            auto* o = new DynamicObject();
+            var v (o);
+            o->setProperty ("group", r.group);
+            o->setProperty ("name", r.name);
+
+            if (r.oscType > 0)      o->setProperty ("oscillator", oscillatorNames[r.oscType - 1]);
+            if (r.stages > 0)       o->setProperty ("stages", r.stages);
+            if (r.channels > 0)     o->setProperty ("channels", r.channels);
+            if (r.blockSize > 0)    o->setProperty ("blockSize", r.blockSize);
+            if (r.sampleRate > 0.0) o->setProperty ("sampleRate", r.sampleRate);
+            if (r.oversampling > 0) o->setProperty ("oversampling", r.oversampling);
+
+            if (r.instances > 0)
+            {
+                o->setProperty ("instances", r.instances);
+                o->setProperty ("instanceBlockMicros", getInstanceBlockMicros (r));
+                o->setProperty ("realTimeLoad", getSessionLoad (r));
+            }
+
+            auto* ns = new DynamicObject();
+            var nsVar (ns);
+            ns->setProperty ("min", r.nsPerSample.min);
+            ns->setProperty ("median", r.nsPerSample.median);
+            ns->setProperty ("mean", r.nsPerSample.mean);
+            ns->setProperty ("stddev", r.nsPerSample.stddev);
+            ns->setProperty ("max", r.nsPerSample.max);
+
+            o->setProperty ("nsPerSample", nsVar);
+
+            if (settings.counters != nullptr)
+            {
+                auto* counts = new DynamicObject();
+                var countsVar (counts);
+
+                for (int i = 0; i < PerfCounters::numCounters; ++i)
+                    if (r.nsPerSample.perSample[i] >= 0.0)
+                        counts->setProperty (PerfCounters::getName ((PerfCounters::Counter) i), r.nsPerSample.perSample[i]);
+
+                if (getIpc (r.nsPerSample) > 0.0)
+                    counts->setProperty ("ipc", getIpc (r.nsPerSample));
+
+                o->setProperty ("countersPerSample", countsVar);
+            }
+
+            o->setProperty ("samplesPerSecond", r.nsPerSample.median > 0.0 ? 1.0e9 / r.nsPerSample.median : 0.0);
+            list.add (v);
+        }
+
+        auto* root = new DynamicObject();
+        var rootVar (root);
+        root->setProperty ("build", buildVar);
+        root->setProperty ("settings", configVar);
+        root->setProperty ("footprint", memoryVar);
+        root->setProperty ("results", list);
+        return rootVar;
+    }
+
+    int printUsage()
+    {
+        printf ("usage: Benchmarks [--quick] [--group oscillator|cascade|processBlock|instances|oversampling] [--json file]\n"
+                "                  [--repetitions n] [--warmup n] [--samples n]\n"
+                "                  [--rates a,b] [--blocks a,b] [--stages a,b] [--instances a,b]\n"
+                "                  [--no-counters] [--fp-assist-event raw]\n");
+        return 1;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    Settings settings;
+    bool useCounters = true;
+    uint64 fpAssistEvent = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+        const String next (i + 1 < argc ? argv[i + 1] : "");
+
+        if (arg == "--quick")
+        {
+            settings.sampleRates = { 48000.0 };
+            settings.blockSizes = { 64, 512 };
+            settings.stageCounts = { 4, 16 };
+            settings.instanceCounts = { 1, 64, 256 };
+            settings.repetitions = 5;
+            settings.samplesPerRepetition = 16384;
+        }
+        else if (arg == "--group")         { settings.group = next; ++i; }
+        else if (arg == "--json")          { settings.jsonFile = File::getCurrentWorkingDirectory().getChildFile (next); ++i; }
+        else if (arg == "--repetitions")   { settings.repetitions = jmax (1, next.getIntValue()); ++i; }
+        else if (arg == "--warmup")        { settings.warmup = jmax (0, next.getIntValue()); ++i; }
+        else if (arg == "--samples")       { settings.samplesPerRepetition = jmax (256, next.getIntValue()); ++i; }
+        else if (arg == "--rates")         { settings.sampleRates = parseDoubles (next); ++i; }
+        else if (arg == "--blocks")        { settings.blockSizes = parseInts (next); ++i; }
+        else if (arg == "--stages")        { settings.stageCounts = parseInts (next); ++i; }
+        else if (arg == "--instances")     { settings.instanceCounts = parseInts (next); ++i; }
+        else if (arg == "--no-counters")   useCounters = false;
+        else if (arg == "--fp-assist-event") { fpAssistEvent = (uint64) next.getHexValue64(); ++i; }
+        else                               return printUsage();
+    }
+
+    ScopedPointer<PerfCounters> counters;
+
+    if (useCounters)
+    {
+        counters = new PerfCounters (fpAssistEvent);
+
+        if (counters->getProblems().isNotEmpty())
+            printf ("hardware counters %s\n\n", counters->getProblems().toRawUTF8());
+
+        if (counters->isAnyAvailable())
+            settings.counters = counters;
+    }
+
+    const Footprint footprint (getFootprint());
+    printFootprint (footprint);
+
+    ScopedNoDenormals noDenormals;
+    Array<BenchmarkResult> results;
+
+    if (settings.group.isEmpty() || settings.group == "oscillator")    benchmarkOscillators (settings, results);
+    if (settings.group.isEmpty() || settings.group == "cascade")       benchmarkCascade (settings, results);
+    if (settings.group.isEmpty() || settings.group == "processBlock")  benchmarkProcessBlock (settings, results);
+    if (settings.group.isEmpty() || settings.group == "instances")     benchmarkInstances (settings, results);
+    if (settings.group.isEmpty() || settings.group == "oversampling")  benchmarkOversampling (settings, results);
+
+    if (results.isEmpty())
+        return printUsage();
+
+    if (settings.jsonFile != File())
+    {
+        if (! settings.jsonFile.replaceWithText (JSON::toString (toJson (settings, footprint, results))))
+        {
+            printf ("can't write %s\n", settings.jsonFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        printf ("\nwrote %d results to %s\n", results.size(), settings.jsonFile.getFullPathName().toRawUTF8());
+    }
+
+    return 0;
+}
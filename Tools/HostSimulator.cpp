@@ -0,0 +1,236 @@
+/*
+  ==============================================================================
+
+    HostSimulator.cpp
+    Author:  eric carmi
+
+    Drives the plugin the way a host would and reports how long each
+    processBlock call takes compared to the real-time deadline.
+
+    For every sample rate and buffer size, every oscillator type and stage
+    count get their own run of simulated audio with automated parameters.
+    Hosts don't always deliver full blocks, so the block length varies a bit
+    from call to call, and part of each period is taken away to model
+    callback jitter before the deadline check.
+
+    Usage: HostSimulator [--quick] [--seconds s] [--rates 44100,48000]
+                         [--blocks 64,512] [--stages 4,16] [--jitter 0.1]
+                         [--csv file] [--fail-on-miss]
+
+  ==============================================================================
+*/
+
+#include "../Source/PluginProcessor.h"
+#include <algorithm>
+#include <vector>
+
+extern AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    struct Settings
+    {
+        Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+        Array<int> blockSizes { 32, 64, 128, 256, 512, 1024, 2048 };
+        Array<int> stageCounts { 1, 4, 8, 12, 16 };
+        double secondsPerRun = 1.0;
+        double jitter = 0.1;            // largest fraction of a period lost before the callback
+        File csvFile;
+        bool failOnMiss = false;
+    };
+
+    struct RunResult
+    {
+        double p50, p99, p999, max;     // microseconds
+        double budget;                  // microseconds for a full block
+        int numBlocks, numMisses;
+    };
+
+    Array<double> parseDoubles (const String& list)
+    {
+        Array<double> values;
+        for (auto& token : StringArray::fromTokens (list, ",", ""))
+            values.add (token.getDoubleValue());
+        return values;
+    }
+
+    Array<int> parseInts (const String& list)
+    {
+        Array<int> values;
+        for (auto& token : StringArray::fromTokens (list, ",", ""))
+            values.add (token.getIntValue());
+        return values;
+    }
+
+    double percentile (const std::vector<double>& sorted, double p)
+    {
+        const size_t index = (size_t) (p * (sorted.size() - 1) + 0.5);
+        return sorted[jmin (index, sorted.size() - 1)];
+    }
+
+    // Moves the parameters around like host automation would, through the normalised values
+    void automate (PhazerAudioProcessor& p, Random& random, int blockIndex)
+    {
+        const float phase = blockIndex * 0.01f;
+
+        p.rateParam->setValueNotifyingHost (0.5f + 0.5f * std::sin (phase));
+        p.centerfreqParam->setValueNotifyingHost (0.5f + 0.5f * std::sin (phase * 1.3f));
+        p.depthParam->setValueNotifyingHost (0.5f + 0.4f * std::sin (phase * 0.7f));
+        p.widthParam->setValueNotifyingHost (random.nextFloat());
+
+        if (random.nextInt (100) == 0)
+            p.mixParam->setValueNotifyingHost (random.nextFloat());
+    }
+
+    RunResult runOne (const Settings& settings, double sampleRate, int blockSize, int oscType, int stages)
+    {
+        ScopedPointer<PhazerAudioProcessor> processor (static_cast<PhazerAudioProcessor*> (createPluginFilter()));
+        PhazerAudioProcessor& p = *processor;
+
+        p.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+        p.prepareToPlay (sampleRate, blockSize);
+        p.engine.oscillator.setType (oscType);
+        *p.stageParam = stages;
+        *p.mixParam = 0.5f;
+
+        AudioBuffer<float> buffer (2, blockSize);
+        MidiBuffer midi;
+        Random random (oscType * 1000 + stages);
+
+        const int numBlocks = jmax (1, (int) (settings.secondsPerRun * sampleRate / blockSize));
+        std::vector<double> times;
+        times.reserve ((size_t) numBlocks);
+        int numMisses = 0;
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            // Mostly full blocks, sometimes a shorter one
+            const int numSamples = random.nextInt (8) == 0 ? jmax (1, blockSize - random.nextInt (blockSize / 2 + 1))
+                                                           : blockSize;
+
+            AudioBuffer<float> block (buffer.getArrayOfWritePointers(), 2, numSamples);
+
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                float* data = block.getWritePointer (chan);
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = random.nextFloat() * 2.0f - 1.0f;
+            }
+
+            automate (p, random, b);
+
+            const int64 start = Time::getHighResolutionTicks();
+            p.processBlock (block, midi);
+            const double micros = 1.0e6 * Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            const double deadline = 1.0e6 * numSamples / sampleRate * (1.0 - settings.jitter * random.nextDouble());
+
+            if (micros > deadline)
+                ++numMisses;
+
+            times.push_back (micros);
+        }
+
+        p.releaseResources();
+
+        std::sort (times.begin(), times.end());
+
+        RunResult r;
+        r.p50 = percentile (times, 0.5);
+        r.p99 = percentile (times, 0.99);
+        r.p999 = percentile (times, 0.999);
+        r.max = times.back();
+        r.budget = 1.0e6 * blockSize / sampleRate;
+        r.numBlocks = numBlocks;
+        r.numMisses = numMisses;
+        return r;
+    }
+
+    const char* oscillatorName (int type)
+    {
+        static const char* names[] = { "Sine", "Triangle", "Square", "Saw", "AASquare", "AASaw",
+                                       "Vanderpol", "Duffing", "Chua", "Lorenz" };
+        return names[type - 1];
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    Settings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+        const String next (i + 1 < argc ? argv[i + 1] : "");
+
+        if (arg == "--quick")
+        {
+            settings.sampleRates = { 48000.0 };
+            settings.blockSizes = { 64, 512 };
+            settings.secondsPerRun = 0.25;
+        }
+        else if (arg == "--seconds")       { settings.secondsPerRun = next.getDoubleValue(); ++i; }
+        else if (arg == "--rates")         { settings.sampleRates = parseDoubles (next); ++i; }
+        else if (arg == "--blocks")        { settings.blockSizes = parseInts (next); ++i; }
+        else if (arg == "--stages")        { settings.stageCounts = parseInts (next); ++i; }
+        else if (arg == "--jitter")        { settings.jitter = jlimit (0.0, 0.9, next.getDoubleValue()); ++i; }
+        else if (arg == "--csv")           { settings.csvFile = File::getCurrentWorkingDirectory().getChildFile (next); ++i; }
+        else if (arg == "--fail-on-miss")  { settings.failOnMiss = true; }
+        else
+        {
+            printf ("usage: HostSimulator [--quick] [--seconds s] [--rates a,b] [--blocks a,b] [--stages a,b]\n"
+                    "                     [--jitter fraction] [--csv file] [--fail-on-miss]\n");
+            return 1;
+        }
+    }
+
+    ScopedNoDenormals noDenormals;
+    ScopedPointer<FileOutputStream> csv;
+
+    if (settings.csvFile != File())
+    {
+        settings.csvFile.deleteFile();
+        csv = settings.csvFile.createOutputStream();
+
+        if (csv == nullptr)
+        {
+            printf ("can't write %s\n", settings.csvFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        *csv << "sample_rate,block_size,oscillator,stages,p50_us,p99_us,p999_us,max_us,budget_us,blocks,misses" << newLine;
+    }
+
+    int totalMisses = 0;
+
+    for (auto sampleRate : settings.sampleRates)
+    {
+        for (auto blockSize : settings.blockSizes)
+        {
+            printf ("\n%.0f Hz, %d samples, deadline %.1f us\n", sampleRate, blockSize, 1.0e6 * blockSize / sampleRate);
+            printf ("%-10s %6s %9s %9s %9s %9s %7s %7s\n", "osc", "stages", "p50", "p99", "p99.9", "max", "max %", "misses");
+
+            for (int type = Oscillators::Sine; type <= Oscillators::Lorenz; ++type)
+            {
+                for (auto stages : settings.stageCounts)
+                {
+                    const RunResult r = runOne (settings, sampleRate, blockSize, type, stages);
+                    totalMisses += r.numMisses;
+
+                    printf ("%-10s %6d %9.2f %9.2f %9.2f %9.2f %6.1f%% %7d\n", oscillatorName (type), stages,
+                            r.p50, r.p99, r.p999, r.max, 100.0 * r.max / r.budget, r.numMisses);
+
+                    if (csv != nullptr)
+                        *csv << sampleRate << ',' << blockSize << ',' << oscillatorName (type) << ',' << stages << ','
+                             << r.p50 << ',' << r.p99 << ',' << r.p999 << ',' << r.max << ',' << r.budget << ','
+                             << r.numBlocks << ',' << r.numMisses << newLine;
+                }
+            }
+        }
+    }
+
+    printf ("\n%d deadline misses in total\n", totalMisses);
+
+    return (settings.failOnMiss && totalMisses > 0) ? 1 : 0;
+}
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    PerfCounters.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "PerfCounters.h"
+
+#if JUCE_LINUX
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+ #include <cerrno>
+ #include <cstring>
+#endif
+
+namespace
+{
+   #if JUCE_LINUX
+    const uint64 intelFpAssistAny = 0x1eca;     // event 0xca, umask 0x1e
+
+    int openCounter (uint32 type, uint64 config)
+    {
+        perf_event_attr attr;
+        std::memset (&attr, 0, sizeof (attr));
+        attr.size = sizeof (attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // This thread, on whichever CPU it runs
+        return (int) syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    uint64 cacheReadMiss (uint64 cache)
+    {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+   #endif
+}
+
+PerfCounters::PerfCounters (uint64 rawFpAssistEvent)
+{
+    for (int i = 0; i < numCounters; ++i)
+    {
+        fds[i] = -1;
+        values[i] = 0.0;
+    }
+
+   #if JUCE_LINUX
+    uint64 fpAssistEvent = rawFpAssistEvent;
+
+    if (fpAssistEvent == 0 && SystemStats::getCpuVendor() == "GenuineIntel")
+        fpAssistEvent = intelFpAssistAny;
+
+    const struct { uint32 type; uint64 config; } events[numCounters] =
+    {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, cacheReadMiss (PERF_COUNT_HW_CACHE_L1D) },
+        { PERF_TYPE_HW_CACHE, cacheReadMiss (PERF_COUNT_HW_CACHE_LL) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_RAW,      fpAssistEvent }
+    };
+
+    StringArray missing;
+
+    for (int i = 0; i < numCounters; ++i)
+    {
+        if (i == fpAssists && fpAssistEvent == 0)
+        {
+            missing.add (String (getName (fpAssists)) + " (no known event for this CPU)");
+            continue;
+        }
+
+        fds[i] = openCounter (events[i].type, events[i].config);
+
+        if (fds[i] < 0)
+            missing.add (String (getName ((Counter) i)) + " (" + String (std::strerror (errno)) + ")");
+    }
+
+    if (! missing.isEmpty())
+        problems = "unavailable: " + missing.joinIntoString (", ")
+                     + ", see /proc/sys/kernel/perf_event_paranoid";
+   #else
+    ignoreUnused (rawFpAssistEvent);
+    problems = "hardware counters need Linux perf_event_open";
+   #endif
+}
+
+PerfCounters::~PerfCounters()
+{
+   #if JUCE_LINUX
+    for (auto fd : fds)
+        if (fd >= 0)
+            close (fd);
+   #endif
+}
+
+bool PerfCounters::isAnyAvailable() const noexcept
+{
+    for (auto fd : fds)
+        if (fd >= 0)
+            return true;
+
+    return false;
+}
+
+void PerfCounters::start() noexcept
+{
+   #if JUCE_LINUX
+    for (auto fd : fds)
+    {
+        if (fd >= 0)
+        {
+            ioctl (fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl (fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+   #endif
+}
+
+void PerfCounters::stop() noexcept
+{
+   #if JUCE_LINUX
+    for (auto fd : fds)
+        if (fd >= 0)
+            ioctl (fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    for (int i = 0; i < numCounters; ++i)
+    {
+        values[i] = 0.0;
+        uint64 data[3];     // value, time enabled, time running
+
+        if (fds[i] >= 0 && read (fds[i], data, sizeof (data)) == (ssize_t) sizeof (data) && data[2] > 0)
+            values[i] = (double) data[0] * ((double) data[1] / (double) data[2]);
+    }
+   #endif
+}
+
+const char* PerfCounters::getName (Counter counter) noexcept
+{
+    switch (counter)
+    {
+        case cycles:        return "cycles";
+        case instructions:  return "instructions";
+        case l1dMisses:     return "l1dMisses";
+        case llcMisses:     return "llcMisses";
+        case branchMisses:  return "branchMisses";
+        case fpAssists:     return "fpAssists";
+        default:            break;
+    }
+
+    return "";
+}
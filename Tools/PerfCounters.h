@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    PerfCounters.h
+    Author:  eric carmi
+
+    Hardware performance counters for the calling thread, through Linux
+    perf_event_open, for the benchmarks.
+
+    Each counter is opened on its own, so one the CPU or kernel doesn't offer
+    doesn't take the others with it, and only user space is counted, which
+    perf_event_paranoid allows up to level 2. When the kernel has to share
+    the hardware counters between more events than it has, values are scaled
+    up by the fraction of the time each one was actually counting.
+
+    FP assists are microcode assists for denormal inputs and outputs. There's
+    no generic event for them, so it's a raw event: FP_ASSIST.ANY (0x1eca) on
+    Intel before Ice Lake, which newer Intel parts and other vendors don't
+    have. On anything but Intel it's left closed unless a raw event code is
+    given, see setFpAssistEvent().
+
+    On other platforms nothing is available and everything reads zero.
+
+  ==============================================================================
+*/
+
+#ifndef PERFCOUNTERS_H_INCLUDED
+#define PERFCOUNTERS_H_INCLUDED
+
+#include "../Source/DspHeader.h"
+
+class PerfCounters
+{
+public:
+    enum Counter
+    {
+        cycles,
+        instructions,
+        l1dMisses,          // L1 data cache read misses
+        llcMisses,          // last level cache read misses
+        branchMisses,
+        fpAssists,
+        numCounters
+    };
+
+    // rawFpAssistEvent replaces the default FP assist event, 0 keeps it
+    explicit PerfCounters (uint64 rawFpAssistEvent = 0);
+    ~PerfCounters();
+
+    bool isAvailable (Counter counter) const noexcept     { return fds[counter] >= 0; }
+    bool isAnyAvailable() const noexcept;
+
+    // Why counters are missing, empty when they're all there
+    String getProblems() const                             { return problems; }
+
+    // Zeroes and starts every available counter
+    void start() noexcept;
+
+    // Stops them and reads the values
+    void stop() noexcept;
+
+    // Counted between the last start() and stop(), scaled for multiplexing
+    double getValue (Counter counter) const noexcept       { return values[counter]; }
+
+    static const char* getName (Counter counter) noexcept;
+
+private:
+    int fds[numCounters];
+    double values[numCounters];
+    String problems;
+
+    JUCE_DECLARE_NON_COPYABLE (PerfCounters)
+};
+
+#endif  // PERFCOUNTERS_H_INCLUDED
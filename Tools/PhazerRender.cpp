@@ -0,0 +1,713 @@
+/*
+  ==============================================================================
+
+    PhazerRender.cpp
+    Author:  eric carmi
+
+    Renders an audio file through the phaser without a host or GUI.
+
+    The file is streamed through the engine in large blocks, so memory use
+    doesn't depend on its length. Reading and writing run on their own
+    threads (see RenderPipeline), and WAV and AIFF inputs are memory mapped.
+    A long single file is split into segments rendered on all cores instead
+    (see SegmentedRender), which gives exactly the same output.
+
+    Parameters come from the command line or a preset file; both use the
+    plugin parameter names and ranges. Options are applied in order, so
+    anything after --preset overrides the preset.
+
+    A preset file has one "name=value" per line, '#' starts a comment:
+
+        osc=Lorenz
+        rate=2.5
+        stages=8
+
+    With --batch, every line of a manifest names an input, an output and
+    optionally its own settings. The files are rendered in parallel, one
+    engine per worker thread, with a work-stealing scheduler spreading them
+    over the workers (--jobs, all cores by default).
+
+    --oversample runs the engine at 2, 4 or 8 times the file's rate, see
+    Oversampler.h. The filters delay the output, so the render drops that many
+    samples from the start and runs on over as much silence past the end: the
+    output lines up with the input and has the same length.
+
+    --automation takes breakpoints for rate, depth, width, freq, mix and
+    stages from a CSV or binary file (see Automation.h). Blocks are split at
+    every breakpoint and each piece ramps exactly, sample for sample, in place
+    of the usual parameter smoothing. --convert-automation turns a CSV file
+    into the binary form.
+
+    --make-bank collects preset files into a bank for the plugin's programs
+    (see PresetBank), named after the files, in the order given.
+
+    Usage: phazer-render [options] input output [--jobs n] [--preroll seconds]
+           phazer-render [options] --batch manifest [--jobs n]
+           phazer-render --make-bank bank preset...
+           phazer-render --convert-automation csv binary
+        --rate hz  --depth x  --width x  --freq hz  --mix x  --stages n
+        --osc name|number  --ic1 x  --ic2 x  --ic3 x  --power on|off
+        --oversample 1|2|4|8  --preset file  --automation file
+        --block samples  --bits n
+
+  ==============================================================================
+*/
+
+#include "../Source/PhazerEngine.h"
+#include "../Source/PresetBank.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "Automation.h"
+#include "RenderPipeline.h"
+#include "SegmentedRender.h"
+#include "WorkStealingScheduler.h"
+#include <algorithm>
+
+namespace
+{
+    struct RenderSettings
+    {
+        PhazerParameters params;
+        int oscType = Oscillators::Sine;
+        double ICs[3] = { 0.0, 0.0, 0.0 };
+        bool setICs = false;
+
+        int blockSize = 65536;
+        int bitsPerSample = 0;          // 0 keeps the input's bit depth
+
+        File automation;
+
+        int maxSegments = 1;            // more than 1 renders a long file in parallel segments
+        double prerollSeconds = 1.0;
+    };
+
+    const char* oscillatorNames[] = { "Sine", "Triangle", "Square", "Saw", "AASquare", "AASaw",
+                                      "Vanderpol", "Duffing", "Chua", "Lorenz" };
+
+    int parseOscillator (const String& text)
+    {
+        for (int i = 0; i < numElementsInArray (oscillatorNames); ++i)
+            if (text.equalsIgnoreCase (oscillatorNames[i]))
+                return i + 1;
+
+        const int type = text.getIntValue();
+        return (type >= Oscillators::Sine && type <= Oscillators::Lorenz) ? type : 0;
+    }
+
+    // Shared by the command line and preset files. Returns false for unknown names.
+    bool applySetting (RenderSettings& settings, const String& name, const String& value)
+    {
+        PhazerParameters& p = settings.params;
+
+        if      (name == "rate")     p.rate = value.getFloatValue();
+        else if (name == "depth")    p.depth = value.getFloatValue();
+        else if (name == "width")    p.width = value.getFloatValue();
+        else if (name == "freq")     p.centerfreq = value.getFloatValue();
+        else if (name == "mix")      p.mix = value.getFloatValue();
+        else if (name == "stages")   p.stages = value.getIntValue();
+        else if (name == "power")    p.power = (value == "on" || value.getIntValue() != 0);
+        else if (name == "oversample")
+        {
+            const int factor = value.getIntValue();
+
+            if (factor < 1 || ! isPowerOfTwo (factor) || factor > (1 << Oversampler::maxFactorLog2))
+                return false;
+
+            p.oversampling = (int) std::log2 (factor);
+        }
+        else if (name == "osc")
+        {
+            settings.oscType = parseOscillator (value);
+            return settings.oscType != 0;
+        }
+        else if (name.startsWith ("ic") && name.length() == 3 && name.getLastCharacter() >= '1' && name.getLastCharacter() <= '3')
+        {
+            settings.ICs[name.getLastCharacter() - '1'] = jlimit (-1.0, 1.0, value.getDoubleValue());
+            settings.setICs = true;
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    bool loadPreset (RenderSettings& settings, const File& file)
+    {
+        if (! file.existsAsFile())
+        {
+            printf ("can't open preset %s\n", file.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        StringArray lines;
+        file.readLines (lines);
+
+        for (auto& line : lines)
+        {
+            const String setting (line.upToFirstOccurrenceOf ("#", false, false).trim());
+
+            if (setting.isEmpty())
+                continue;
+
+            if (! applySetting (settings, setting.upToFirstOccurrenceOf ("=", false, false).trim().toLowerCase(),
+                                setting.fromFirstOccurrenceOf ("=", false, false).trim()))
+            {
+                printf ("%s: bad setting '%s'\n", file.getFileName().toRawUTF8(), setting.toRawUTF8());
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool applyPresetOrSetting (RenderSettings& settings, const String& name, const String& value, const File& directory)
+    {
+        if (name == "preset")
+            return loadPreset (settings, directory.getChildFile (value));
+
+        if (name == "automation")
+        {
+            settings.automation = directory.getChildFile (value);
+            return true;
+        }
+
+        if (! applySetting (settings, name, value))
+        {
+            printf ("unknown option or value: %s %s\n", name.toRawUTF8(), value.toRawUTF8());
+            return false;
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    struct RenderJob
+    {
+        File input, output;
+        RenderSettings settings;
+    };
+
+    struct RenderResult
+    {
+        String error;
+        double audioSeconds = 0.0;
+        double seconds = 0.0;
+        int numSegments = 1;
+        int numRepaired = 0;
+        int latencySamples = 0;
+    };
+
+    // One line per job: "input output [name=value ...]". Paths are relative to the
+    // manifest, quote them if they contain spaces. The settings on a line, including
+    // preset=file, are applied on top of the ones from the command line.
+    bool loadManifest (const File& manifest, const RenderSettings& defaults, OwnedArray<RenderJob>& jobs)
+    {
+        if (! manifest.existsAsFile())
+        {
+            printf ("can't open manifest %s\n", manifest.getFullPathName().toRawUTF8());
+            return false;
+        }
+
+        const File directory (manifest.getParentDirectory());
+        StringArray lines;
+        manifest.readLines (lines);
+
+        for (int lineNumber = 0; lineNumber < lines.size(); ++lineNumber)
+        {
+            const StringArray tokens (StringArray::fromTokens (lines[lineNumber].upToFirstOccurrenceOf ("#", false, false), true));
+
+            if (tokens.isEmpty())
+                continue;
+
+            if (tokens.size() < 2)
+            {
+                printf ("%s:%d: expected an input and an output file\n", manifest.getFileName().toRawUTF8(), lineNumber + 1);
+                return false;
+            }
+
+            auto* job = jobs.add (new RenderJob());
+            job->input = directory.getChildFile (tokens[0].unquoted());
+            job->output = directory.getChildFile (tokens[1].unquoted());
+            job->settings = defaults;
+
+            for (int i = 2; i < tokens.size(); ++i)
+            {
+                const String name (tokens[i].upToFirstOccurrenceOf ("=", false, false).trim().toLowerCase());
+                const String value (tokens[i].fromFirstOccurrenceOf ("=", false, false).trim().unquoted());
+
+                if (! applyPresetOrSetting (job->settings, name, value, directory))
+                {
+                    printf ("  in %s line %d\n", manifest.getFileName().toRawUTF8(), lineNumber + 1);
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //==============================================================================
+    // WAV and AIFF inputs are memory mapped, so reading is just page faults and
+    // sample conversion. Other formats go through their normal reader.
+    AudioFormatReader* createReader (AudioFormatManager& formats, const File& file)
+    {
+        if (AudioFormat* format = formats.findFormatForFileExtension (file.getFileExtension()))
+        {
+            ScopedPointer<MemoryMappedAudioFormatReader> mapped (format->createMemoryMappedReader (file));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped.release();
+        }
+
+        return formats.createReaderFor (file);
+    }
+
+    // Streams one file through the engine. The pipeline's chunks belong to the
+    // caller, so a worker rendering many files never allocates more audio buffers.
+    RenderResult renderFile (const RenderJob& job, AudioFormatManager& formats, PhazerEngine& engine, RenderPipeline& pipeline)
+    {
+        RenderResult result;
+        const RenderSettings& settings = job.settings;
+
+        ScopedPointer<AudioFormatReader> reader (createReader (formats, job.input));
+
+        if (reader == nullptr)
+        {
+            result.error = "can't read " + job.input.getFullPathName();
+            return result;
+        }
+
+        const int numChannels = (int) reader->numChannels;
+
+        if (numChannels != 1 && numChannels != 2)
+        {
+            result.error = "only mono and stereo files are supported, " + job.input.getFileName()
+                             + " has " + String (numChannels) + " channels";
+            return result;
+        }
+
+        AudioFormat* outputFormat = formats.findFormatForFileExtension (job.output.getFileExtension());
+
+        if (outputFormat == nullptr)
+        {
+            result.error = "no audio format for " + job.output.getFileName();
+            return result;
+        }
+
+        int bits = settings.bitsPerSample > 0 ? settings.bitsPerSample : (int) reader->bitsPerSample;
+        if (! outputFormat->getPossibleBitDepths().contains (bits))
+            bits = outputFormat->getPossibleBitDepths().getLast();
+
+        job.output.deleteFile();
+        ScopedPointer<FileOutputStream> outputStream (job.output.createOutputStream());
+        ScopedPointer<AudioFormatWriter> writer;
+
+        if (outputStream != nullptr)
+            writer = outputFormat->createWriterFor (outputStream, reader->sampleRate, (unsigned int) numChannels,
+                                                    bits, StringPairArray(), 0);
+
+        if (writer == nullptr)
+        {
+            result.error = "can't write " + job.output.getFullPathName();
+            return result;
+        }
+
+        outputStream.release();     // the writer owns it now
+
+        PhazerParameters params (settings.params);
+        params.limit();
+
+        engine.prepare (reader->sampleRate, pipeline.getBlockSize());
+        engine.setOversampling (params.oversampling);
+        engine.reset();
+        engine.oscillator.setType (settings.oscType);
+
+        if (settings.setICs)
+        {
+            for (int i = 0; i < 3; ++i)
+                engine.ICs[i] = settings.ICs[i];
+
+            engine.resetICflag = true;
+        }
+
+        Automation automation;
+
+        if (settings.automation != File())
+        {
+            result.error = automation.load (settings.automation);
+
+            if (result.error.isNotEmpty())
+                return result;
+
+            automation.prepare (reader->sampleRate);
+        }
+
+        const int64 startTicks = Time::getHighResolutionTicks();
+
+        // Segments shorter than a few blocks would spend most of their time in the pre-roll.
+        // The segment pre-pass doesn't know about automation, so that always renders serially.
+        const int64 numBlocks = reader->lengthInSamples / pipeline.getBlockSize();
+        result.numSegments = (int) jlimit ((int64) 1, (int64) jmax (1, settings.maxSegments), numBlocks / 4);
+
+        if (! automation.isEmpty())
+            result.numSegments = 1;
+
+        String error;
+
+        if (! automation.isEmpty())
+        {
+            error = pipeline.run (*reader, *writer, [&] (AudioBuffer<float>& block, int64 position)
+                                  {
+                                      const int64 end = position + block.getNumSamples();
+
+                                      for (int64 pos = position; pos < end;)
+                                      {
+                                          const int64 next = automation.getNextBreakpoint (pos, end);
+                                          AudioBuffer<float> piece (block.getArrayOfWritePointers(), block.getNumChannels(),
+                                                                    (int) (pos - position), (int) (next - pos));
+                                          PhazerParameters from, to;
+
+                                          automation.getRamp (pos, next, params, from, to);
+                                          engine.processRamp (piece, from, to);
+                                          pos = next;
+                                      }
+                                  }, engine.getLatencySamples());
+        }
+        else if (result.numSegments > 1)
+        {
+            SegmentedRender::Options options;
+            options.numSegments = options.numThreads = result.numSegments;
+            options.blockSize = pipeline.getBlockSize();
+            options.prerollSeconds = settings.prerollSeconds;
+
+            SegmentedRender segmented ([&] { return createReader (formats, job.input); }, params,
+                                       [&] (PhazerEngine& e)
+                                       {
+                                           e.oscillator.setType (engine.oscillator.getType());
+                                           e.resetICflag = engine.resetICflag;
+
+                                           for (int i = 0; i < 3; ++i)
+                                               e.ICs[i] = engine.ICs[i];
+                                       },
+                                       options);
+
+            error = segmented.run (*writer);
+            result.numRepaired = segmented.getNumRepaired();
+        }
+        else
+        {
+            error = pipeline.run (*reader, *writer, [&] (AudioBuffer<float>& block, int64)
+                                  {
+                                      engine.process (block, params);
+                                  }, engine.getLatencySamples());
+        }
+
+        if (error.isNotEmpty())
+        {
+            result.error = error + " in " + job.output.getFileName();
+            return result;
+        }
+
+        writer = nullptr;
+
+        result.latencySamples = engine.getLatencySamples();
+        result.seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+        result.audioSeconds = reader->lengthInSamples / reader->sampleRate;
+        return result;
+    }
+
+    double realTimeFactor (double audioSeconds, double seconds)
+    {
+        return seconds > 0.0 ? audioSeconds / seconds : 0.0;
+    }
+
+    void printResult (const RenderJob& job, const RenderResult& r)
+    {
+        if (r.error.isNotEmpty())
+            printf ("%s: %s\n", job.output.getFileName().toRawUTF8(), r.error.toRawUTF8());
+        else
+            printf ("%s: %.1f s of audio in %.2f s (%.0fx real time)\n", job.output.getFileName().toRawUTF8(),
+                    r.audioSeconds, r.seconds, realTimeFactor (r.audioSeconds, r.seconds));
+
+        if (r.numSegments > 1)
+            printf ("    %d segments, %d rendered again to match the seams\n", r.numSegments, r.numRepaired);
+
+        if (r.latencySamples > 0)
+            printf ("    oversampled, %d samples of filter latency taken out\n", r.latencySamples);
+    }
+
+    //==============================================================================
+    // One engine, one format manager and one pipeline per worker, so memory
+    // stays bounded by the number of workers whatever the size of the batch
+    class RenderWorker  : public Thread
+    {
+    public:
+        RenderWorker (int workerIndex, WorkStealingScheduler& s, const OwnedArray<RenderJob>& j,
+                      Array<RenderResult>& r, CriticalSection& outputLock, int blockSize)
+            : Thread ("Phazer render worker " + String (workerIndex)),
+              index (workerIndex), scheduler (s), jobs (j), results (r), printLock (outputLock),
+              pipeline (2, blockSize)
+        {
+            formats.registerBasicFormats();
+        }
+
+        PHAZER_DECLARE_ALIGNED_NEW (RenderWorker)
+
+        void run() override
+        {
+            ScopedNoDenormals noDenormals;
+            int job;
+
+            while (! threadShouldExit() && (job = scheduler.next (index)) >= 0)
+            {
+                // Each result slot belongs to a single job, so no lock is needed to fill it in
+                RenderResult& r = results.getReference (job);
+                r = renderFile (*jobs[job], formats, engine, pipeline);
+
+                const ScopedLock sl (printLock);
+                printResult (*jobs[job], r);
+            }
+
+            engine.release();
+        }
+
+    private:
+        const int index;
+        WorkStealingScheduler& scheduler;
+        const OwnedArray<RenderJob>& jobs;
+        Array<RenderResult>& results;
+        CriticalSection& printLock;
+
+        AudioFormatManager formats;
+        PhazerEngine engine;
+        RenderPipeline pipeline;
+
+        JUCE_DECLARE_NON_COPYABLE (RenderWorker)
+    };
+
+    int renderBatch (OwnedArray<RenderJob>& jobs, int numWorkers, int blockSize)
+    {
+        numWorkers = jlimit (1, jmax (1, jobs.size()), numWorkers);
+
+        // Largest inputs first, file size is a good enough guess at the cost
+        Array<int> order;
+        for (int i = 0; i < jobs.size(); ++i)
+            order.add (i);
+
+        std::sort (order.begin(), order.end(), [&jobs] (int a, int b)
+                   { return jobs[a]->input.getSize() > jobs[b]->input.getSize(); });
+
+        WorkStealingScheduler scheduler (numWorkers, order);
+        Array<RenderResult> results;
+        results.resize (jobs.size());
+        CriticalSection printLock;
+
+        printf ("rendering %d files on %d workers\n", jobs.size(), numWorkers);
+
+        const int64 startTicks = Time::getHighResolutionTicks();
+
+        OwnedArray<RenderWorker> workers;
+        for (int i = 0; i < numWorkers; ++i)
+            workers.add (new RenderWorker (i, scheduler, jobs, results, printLock, blockSize))->startThread();
+
+        for (auto* w : workers)
+            w->waitForThreadToExit (-1);
+
+        const double seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+
+        double audioSeconds = 0.0, busySeconds = 0.0;
+        int numFailed = 0;
+
+        for (auto& r : results)
+        {
+            audioSeconds += r.audioSeconds;
+            busySeconds += r.seconds;
+
+            if (r.error.isNotEmpty())
+                ++numFailed;
+        }
+
+        printf ("\n%d files, %.1f s of audio in %.2f s: %.0fx real time overall, %.0fx per worker\n",
+                jobs.size() - numFailed, audioSeconds, seconds, realTimeFactor (audioSeconds, seconds),
+                realTimeFactor (audioSeconds, busySeconds));
+
+        if (numFailed > 0)
+            printf ("%d files failed\n", numFailed);
+
+        return numFailed > 0 ? 1 : 0;
+    }
+
+    //==============================================================================
+    int makeBank (const File& bankFile, const StringArray& presetFiles)
+    {
+        StringArray names;
+        Array<PhazerState> states;
+
+        for (auto& path : presetFiles)
+        {
+            const File file (File::getCurrentWorkingDirectory().getChildFile (path));
+            RenderSettings settings;
+
+            if (! loadPreset (settings, file))
+                return 1;
+
+            PhazerState state;
+            state.setParameters (settings.params);
+            state.oscillatorType = settings.oscType;
+
+            for (int i = 0; i < 3; ++i)
+                state.ICs[i] = (float) settings.ICs[i];
+
+            state.read (&state, sizeof (state));    // the plugin's range checks
+
+            names.add (file.getFileNameWithoutExtension());
+            states.add (state);
+        }
+
+        if (! PresetBank::write (bankFile, names, states))
+        {
+            printf ("can't write %s\n", bankFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        printf ("%d presets in %s\n", states.size(), bankFile.getFullPathName().toRawUTF8());
+        return 0;
+    }
+
+    int convertAutomation (const File& input, const File& output)
+    {
+        Automation automation;
+        const String error (automation.load (input));
+
+        if (error.isNotEmpty())
+        {
+            printf ("%s\n", error.toRawUTF8());
+            return 1;
+        }
+
+        if (! automation.saveBinary (output))
+        {
+            printf ("can't write %s\n", output.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        return 0;
+    }
+
+    // For --trace, true if there's nothing to write or it was written
+    bool writeTrace (const File& file)
+    {
+        if (file == File())
+            return true;
+
+       #if PHAZER_TRACE
+        if (TraceEvents::writeChromeJson (file))
+            return true;
+
+        printf ("can't write %s\n", file.getFullPathName().toRawUTF8());
+       #else
+        printf ("--trace needs a build with PHAZER_TRACE=1\n");
+       #endif
+
+        return false;
+    }
+
+    int printUsage()
+    {
+        printf ("usage: phazer-render [options] input output [--jobs n] [--preroll seconds]\n"
+                "       phazer-render [options] --batch manifest [--jobs n]\n"
+                "       phazer-render --make-bank bank preset...\n"
+                "       phazer-render --convert-automation csv binary\n"
+                "    --rate hz  --depth x  --width x  --freq hz  --mix x  --stages n\n"
+                "    --osc name|number  --ic1 x  --ic2 x  --ic3 x  --power on|off\n"
+                "    --oversample 1|2|4|8  --preset file  --automation file\n"
+                "    --block samples  --bits n\n"
+                "    --trace file   Chrome trace of the engine's phases, see TraceEvents.h\n");
+        return 1;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    RenderSettings settings;
+    StringArray files;
+    File manifest, traceFile;
+    int numWorkers = SystemStats::getNumCpus();
+
+    if (argc >= 3 && String (argv[1]) == "--make-bank")
+    {
+        StringArray presetFiles;
+
+        for (int i = 3; i < argc; ++i)
+            presetFiles.add (argv[i]);
+
+        return makeBank (File::getCurrentWorkingDirectory().getChildFile (argv[2]), presetFiles);
+    }
+
+    if (argc == 4 && String (argv[1]) == "--convert-automation")
+        return convertAutomation (File::getCurrentWorkingDirectory().getChildFile (argv[2]),
+                                  File::getCurrentWorkingDirectory().getChildFile (argv[3]));
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+
+        if (! arg.startsWith ("--"))
+        {
+            files.add (arg);
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            return printUsage();
+
+        const String name (arg.substring (2));
+        const String value (argv[++i]);
+
+        if      (name == "block")   settings.blockSize = jmax (64, value.getIntValue());
+        else if (name == "bits")    settings.bitsPerSample = value.getIntValue();
+        else if (name == "jobs")    numWorkers = jmax (1, value.getIntValue());
+        else if (name == "preroll") settings.prerollSeconds = jmax (0.0, value.getDoubleValue());
+        else if (name == "batch")   manifest = File::getCurrentWorkingDirectory().getChildFile (value);
+        else if (name == "trace")   traceFile = File::getCurrentWorkingDirectory().getChildFile (value);
+        else if (! applyPresetOrSetting (settings, name, value, File::getCurrentWorkingDirectory()))
+            return printUsage();
+    }
+
+    OwnedArray<RenderJob> jobs;
+
+    if (manifest != File())
+    {
+        if (! files.isEmpty())
+            return printUsage();
+
+        if (! loadManifest (manifest, settings, jobs))
+            return 1;
+
+        const int result = renderBatch (jobs, numWorkers, settings.blockSize);
+        return writeTrace (traceFile) ? result : 1;
+    }
+
+    if (files.size() != 2)
+        return printUsage();
+
+    auto* job = jobs.add (new RenderJob());
+    job->input = File::getCurrentWorkingDirectory().getChildFile (files[0]);
+    job->output = File::getCurrentWorkingDirectory().getChildFile (files[1]);
+    job->settings = settings;
+    job->settings.maxSegments = numWorkers;
+
+    ScopedNoDenormals noDenormals;
+    AudioFormatManager formats;
+    formats.registerBasicFormats();
+    PhazerEngine engine;
+    RenderPipeline pipeline (2, settings.blockSize);
+
+    const RenderResult r = renderFile (*job, formats, engine, pipeline);
+    engine.release();
+    printResult (*job, r);
+
+    return r.error.isEmpty() && writeTrace (traceFile) ? 0 : 1;
+}
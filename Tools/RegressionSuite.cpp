@@ -0,0 +1,720 @@
+/*
+  ==============================================================================
+
+    RegressionSuite.cpp
+    Author:  eric carmi
+
+    Golden output tests for the engine, to check optimisations against.
+
+    Every oscillator type, stage count and sample rate 44.1, 48 and 96 kHz is
+    run over three test signals: a stereo impulse train, a stereo log sweep
+    and mono white noise from a fixed seed. The engine starts fresh for each
+    test and runs on silence until the parameter smoothers have settled, then
+    renders the signal with the LFO fast enough to cover a good part of its
+    cycle. On top of those, fewer stage counts run again oversampled 2x and
+    4x, and with the coefficient tables at the usual LFO rate and at 20 Hz,
+    where the sine swings furthest.
+
+    The exact path is the reference. Its output has to match the corpus bit
+    for bit, so the corpus stores a 64-bit hash per test rather than audio.
+    Approximate paths (the coefficient tables for now) are compared against
+    the exact render of the same test from the same run, and pass if no sample
+    is further from it than the test's tolerance in the corpus. The "tables"
+    tests hash the table path's output instead, so it can't change unnoticed
+    either; the tables are built once the smoothers have settled, from
+    parameters that don't move, so it's as repeatable as the exact path.
+
+    Bit for bit only holds between builds that round the same way, so the
+    tools are built with -ffp-contract=off, see Tools/Makefile.
+
+    The corpus is a text file, one test per line:
+
+        # test                         hash              tolerance
+        Lorenz-8-48000-sweep           0f3a...           0.005
+
+    --record writes it from this build's output, keeping the tolerances already
+    in the file. Only record on a build whose output you trust, and commit the
+    corpus with the change that made it necessary.
+
+    --seams runs the segment seam check instead. For every oscillator type at
+    typical settings, a few seconds of noise are rendered the way phazer-render
+    splits a long file, and the result has to be bit-identical to a serial
+    render without any segment needing to be rendered again, i.e. every
+    segment's filters must have settled to the serial state during its pre-roll.
+
+    Usage: phazer-regress [--corpus file] [--record] [--seams] [--filter text] [--dump dir] [--jobs n]
+        --filter   only runs tests whose names contain the text
+        --dump     writes the output of failing tests there as 32-bit WAV files
+
+  ==============================================================================
+*/
+
+#include "../Source/PhazerEngine.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "WorkStealingScheduler.h"
+#include "SegmentedRender.h"
+#include <algorithm>
+
+namespace
+{
+    const char* oscillatorNames[] = { "Sine", "Triangle", "Square", "Saw", "AASquare", "AASaw",
+                                      "Vanderpol", "Duffing", "Chua", "Lorenz" };
+
+    enum Signal
+    {
+        impulses, sweep, noise,
+        numSignals
+    };
+
+    const char* signalNames[] = { "impulses", "sweep", "noise" };
+
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0 };
+
+    const int blockSize = 512;
+    const int signalLength = 8192;
+    const double settleSeconds = 0.15;          // a little longer than the engine's smoothing time
+    const double defaultTolerance = 0.005;      // for new tests when recording
+    const float defaultLfoRate = 8.0f;
+
+    struct TestCase
+    {
+        int oscType, stages, signal;
+        double sampleRate;
+        int oversampling = 0;                   // log2 of the factor
+        bool tables = false;                    // hashes the coefficient tables' output
+        float lfoRate = defaultLfoRate;
+
+        String getName() const
+        {
+            String name (String (oscillatorNames[oscType - 1]) + "-" + String (stages) + "-"
+                           + String ((int) sampleRate) + "-" + signalNames[signal]);
+
+            if (oversampling > 0)           name << "-" << (1 << oversampling) << "x";
+            if (lfoRate != defaultLfoRate)  name << "-" << roundToInt (lfoRate) << "Hz";
+            if (tables)                     name << "-tables";
+
+            return name;
+        }
+
+        // Roughly how long it takes to render, for the order the workers take them in
+        double getCost() const      { return stages * sampleRate * (1 << oversampling); }
+    };
+
+    //==============================================================================
+    void fillSignal (AudioBuffer<float>& buffer, int signal, double sampleRate)
+    {
+        buffer.clear();
+
+        if (signal == impulses)
+        {
+            // 10 ms apart, the right channel halfway between the left one's
+            const int spacing = roundToInt (sampleRate / 100.0);
+
+            for (int i = 0; i < signalLength; i += spacing)
+            {
+                buffer.setSample (0, i, 0.5f);
+
+                if (i + spacing / 2 < signalLength)
+                    buffer.setSample (1, i + spacing / 2, -0.5f);
+            }
+        }
+        else if (signal == sweep)
+        {
+            // 20 Hz up to 0.45 of the sample rate, the right channel in quadrature
+            const double f0 = 20.0, f1 = 0.45 * sampleRate;
+            const double k = std::log (f1 / f0);
+
+            for (int i = 0; i < signalLength; ++i)
+            {
+                const double t = i / (double) signalLength;
+                const double phase = MathConstants<double>::twoPi * f0 * signalLength / sampleRate / k * (std::exp (t * k) - 1.0);
+
+                buffer.setSample (0, i, (float) (0.5 * std::sin (phase)));
+                buffer.setSample (1, i, (float) (0.25 * std::cos (phase)));
+            }
+        }
+        else
+        {
+            Random random (0x5048415a);
+
+            for (int i = 0; i < signalLength; ++i)
+                buffer.setSample (0, i, random.nextFloat() - 0.5f);
+        }
+    }
+
+    // With the coefficient tables enabled, waits after the smoothers have settled
+    // until the builder has caught up, so the signal really goes through the
+    // tables. Returns false if it never does.
+    bool render (PhazerEngine& engine, const TestCase& test, AudioBuffer<float>& output)
+    {
+        PhazerParameters params;
+        params.rate = test.lfoRate;
+        params.depth = 0.8f;
+        params.width = 0.5f;
+        params.centerfreq = 1000.0f;
+        params.mix = 1.0f;
+        params.stages = test.stages;
+        params.oversampling = test.oversampling;
+
+        const int numChannels = test.signal == noise ? 1 : 2;
+        output.setSize (numChannels, signalLength);
+        fillSignal (output, test.signal, test.sampleRate);
+
+        // Before prepare(), which sets the smoothing up for the oversampled rate
+        engine.setOversampling (test.oversampling);
+        engine.prepare (test.sampleRate, blockSize);
+        engine.reset();
+        engine.oscillator.setType (test.oscType);
+
+        AudioBuffer<float> silence (numChannels, blockSize);
+
+        for (int settle = roundToInt (settleSeconds * test.sampleRate); settle > 0; settle -= blockSize)
+        {
+            silence.clear();
+            AudioBuffer<float> block (silence.getArrayOfWritePointers(), numChannels, 0, jmin (settle, blockSize));
+            engine.process (block, params);
+        }
+
+        if (engine.areCoefficientTablesEnabled())
+        {
+            for (int wait = 0; ! engine.areCoefficientTablesReady(); ++wait)
+            {
+                if (wait == 2000)
+                    return false;
+
+                Thread::sleep (1);
+            }
+        }
+
+        for (int pos = 0; pos < signalLength; pos += blockSize)
+        {
+            AudioBuffer<float> block (output.getArrayOfWritePointers(), numChannels, pos, jmin (blockSize, signalLength - pos));
+            engine.process (block, params);
+        }
+
+        return true;
+    }
+
+    // FNV-1a over the bits of every sample, channel by channel
+    uint64 hashOutput (const AudioBuffer<float>& buffer)
+    {
+        uint64 hash = 0xcbf29ce484222325ull;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const float* data = buffer.getReadPointer (ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                uint32 bits;
+                memcpy (&bits, data + i, sizeof (bits));
+
+                for (int byte = 0; byte < 4; ++byte)
+                {
+                    hash ^= (bits >> (8 * byte)) & 0xff;
+                    hash *= 0x100000001b3ull;
+                }
+            }
+        }
+
+        return hash;
+    }
+
+    bool isFinite (const AudioBuffer<float>& buffer)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                if (! std::isfinite (buffer.getSample (ch, i)))
+                    return false;
+
+        return true;
+    }
+
+    float getMaxDifference (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        float difference = 0.0f;
+
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                difference = jmax (difference, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+
+        return difference;
+    }
+
+    String toHex (uint64 value)
+    {
+        char text[20];
+        snprintf (text, sizeof (text), "%016llx", (unsigned long long) value);
+        return text;
+    }
+
+    //==============================================================================
+    struct Reference
+    {
+        uint64 hash;
+        double tolerance;
+    };
+
+    bool loadCorpus (const File& file, HashMap<String, Reference>& corpus)
+    {
+        if (! file.existsAsFile())
+            return false;
+
+        StringArray lines;
+        file.readLines (lines);
+
+        for (auto& line : lines)
+        {
+            const StringArray tokens (StringArray::fromTokens (line.upToFirstOccurrenceOf ("#", false, false), true));
+
+            if (tokens.size() >= 2)
+                corpus.set (tokens[0], { (uint64) tokens[1].getHexValue64(),
+                                         tokens.size() >= 3 ? tokens[2].getDoubleValue() : defaultTolerance });
+        }
+
+        return true;
+    }
+
+    void dumpOutput (const File& directory, const String& name, const AudioBuffer<float>& buffer, double sampleRate)
+    {
+        directory.createDirectory();
+        const File file (directory.getChildFile (name + ".wav"));
+        file.deleteFile();
+
+        WavAudioFormat wav;
+        ScopedPointer<FileOutputStream> stream (file.createOutputStream());
+        ScopedPointer<AudioFormatWriter> writer;
+
+        if (stream != nullptr)
+            writer = wav.createWriterFor (stream, sampleRate, (unsigned int) buffer.getNumChannels(), 32, StringPairArray(), 0);
+
+        if (writer != nullptr)
+        {
+            stream.release();
+            writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+        }
+    }
+
+    //==============================================================================
+    struct TestResult
+    {
+        uint64 hash = 0;
+        float tableDifference = 0.0f;
+        bool tablesBuilt = true, finite = true;
+        AudioBuffer<float> exact, tables;
+    };
+
+    class TestWorker  : public Thread
+    {
+    public:
+        TestWorker (int workerIndex, WorkStealingScheduler& s, const Array<TestCase>& t, OwnedArray<TestResult>& r, bool keep)
+            : Thread ("Phazer regression worker " + String (workerIndex)),
+              index (workerIndex), scheduler (s), tests (t), results (r), keepOutput (keep)
+        {
+            tableEngine.setCoefficientTablesEnabled (true);
+        }
+
+        PHAZER_DECLARE_ALIGNED_NEW (TestWorker)
+
+        void run() override
+        {
+            ScopedNoDenormals noDenormals;
+            AudioBuffer<float> exact, tables;
+            int job;
+
+            while (! threadShouldExit() && (job = scheduler.next (index)) >= 0)
+            {
+                // Each result belongs to a single test, so no lock is needed to fill it in
+                TestResult& r = *results[job];
+
+                render (exactEngine, tests.getReference (job), exact);
+                r.tablesBuilt = render (tableEngine, tests.getReference (job), tables);
+
+                r.hash = hashOutput (tests.getReference (job).tables ? tables : exact);
+                r.finite = isFinite (exact) && isFinite (tables);
+                r.tableDifference = getMaxDifference (exact, tables);
+
+                if (keepOutput)
+                {
+                    r.exact.makeCopyOf (exact);
+                    r.tables.makeCopyOf (tables);
+                }
+            }
+
+            exactEngine.release();
+            tableEngine.release();
+        }
+
+    private:
+        const int index;
+        WorkStealingScheduler& scheduler;
+        const Array<TestCase>& tests;
+        OwnedArray<TestResult>& results;
+        const bool keepOutput;
+
+        PhazerEngine exactEngine, tableEngine;
+
+        JUCE_DECLARE_NON_COPYABLE (TestWorker)
+    };
+
+    void runTests (const Array<TestCase>& tests, OwnedArray<TestResult>& results, int numWorkers, bool keepOutput)
+    {
+        numWorkers = jlimit (1, jmax (1, tests.size()), numWorkers);
+
+        // Most stages first, they take longest
+        Array<int> order;
+        for (int i = 0; i < tests.size(); ++i)
+        {
+            order.add (i);
+            results.add (new TestResult());
+        }
+
+        std::sort (order.begin(), order.end(), [&tests] (int a, int b)
+                   { return tests[a].getCost() > tests[b].getCost(); });
+
+        WorkStealingScheduler scheduler (numWorkers, order);
+        OwnedArray<TestWorker> workers;
+
+        for (int i = 0; i < numWorkers; ++i)
+            workers.add (new TestWorker (i, scheduler, tests, results, keepOutput))->startThread();
+
+        for (auto* w : workers)
+            w->waitForThreadToExit (-1);
+    }
+
+    //==============================================================================
+    int record (const File& corpusFile, const Array<TestCase>& tests, const OwnedArray<TestResult>& results)
+    {
+        HashMap<String, Reference> previous;
+        loadCorpus (corpusFile, previous);
+
+        String text ("# Golden output hashes for phazer-regress, see Tools/RegressionSuite.cpp\n"
+                     "# test                         hash              tolerance\n");
+
+        for (int i = 0; i < tests.size(); ++i)
+        {
+            const String name (tests[i].getName());
+            const double tolerance = previous.contains (name) ? previous[name].tolerance : defaultTolerance;
+
+            text << name.paddedRight (' ', 30) << " " << toHex (results[i]->hash) << "  " << String (tolerance) << "\n";
+        }
+
+        corpusFile.getParentDirectory().createDirectory();
+
+        if (! corpusFile.replaceWithText (text))
+        {
+            printf ("can't write %s\n", corpusFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        printf ("recorded %d tests in %s\n", tests.size(), corpusFile.getFullPathName().toRawUTF8());
+        return 0;
+    }
+
+    int check (const File& corpusFile, const Array<TestCase>& tests, const OwnedArray<TestResult>& results,
+               const File& dumpDirectory)
+    {
+        HashMap<String, Reference> corpus;
+
+        if (! loadCorpus (corpusFile, corpus))
+        {
+            printf ("no corpus at %s, record one with --record on a build you trust\n",
+                    corpusFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        int numFailed = 0;
+        float worstTableDifference = 0.0f;
+
+        for (int i = 0; i < tests.size(); ++i)
+        {
+            const String name (tests[i].getName());
+            const TestResult& r = *results[i];
+            StringArray problems;
+
+            worstTableDifference = jmax (worstTableDifference, r.tableDifference);
+
+            if (! corpus.contains (name))
+                problems.add ("not in the corpus");
+            else if (r.hash != corpus[name].hash)
+                problems.add ("exact output changed, hash " + toHex (r.hash) + " instead of " + toHex (corpus[name].hash));
+
+            if (! r.finite)
+                problems.add ("output is not finite");
+
+            if (! r.tablesBuilt)
+                problems.add ("the coefficient tables were never built");
+            else if (corpus.contains (name) && ! (r.tableDifference <= corpus[name].tolerance))
+                problems.add ("tables differ by " + String (r.tableDifference) + ", tolerance " + String (corpus[name].tolerance));
+
+            if (problems.isEmpty())
+                continue;
+
+            ++numFailed;
+            printf ("FAIL %s: %s\n", name.toRawUTF8(), problems.joinIntoString ("; ").toRawUTF8());
+
+            if (dumpDirectory != File())
+            {
+                dumpOutput (dumpDirectory, name + "-exact", r.exact, tests[i].sampleRate);
+                dumpOutput (dumpDirectory, name + "-tables", r.tables, tests[i].sampleRate);
+            }
+        }
+
+        printf ("%d tests, %d failed, largest table difference %g\n", tests.size(), numFailed, worstTableDifference);
+        return numFailed > 0 ? 1 : 0;
+    }
+
+    //==============================================================================
+    const double seamSampleRate = 48000.0;
+    const int seamLength = 4 * 48000;
+    const int seamSegments = 4;
+    const int seamBlockSize = 4096;
+    const double seamPrerollSeconds = 1.0;      // phazer-render's default
+
+    class BufferReader  : public AudioFormatReader
+    {
+    public:
+        BufferReader (const AudioBuffer<float>& source, double rate)
+            : AudioFormatReader (nullptr, "buffer"), buffer (source)
+        {
+            sampleRate = rate;
+            bitsPerSample = 32;
+            lengthInSamples = source.getNumSamples();
+            numChannels = (unsigned int) source.getNumChannels();
+            usesFloatingPointData = true;
+        }
+
+        bool readSamples (int** destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                          int64 startSampleInFile, int numSamples) override
+        {
+            clearSamplesBeyondAvailableLength (destChannels, numDestChannels, startOffsetInDestBuffer,
+                                               startSampleInFile, numSamples, lengthInSamples);
+
+            for (int ch = 0; ch < jmin (numDestChannels, buffer.getNumChannels()); ++ch)
+                if (destChannels[ch] != nullptr && numSamples > 0)
+                    memcpy (destChannels[ch] + startOffsetInDestBuffer, buffer.getReadPointer (ch, (int) startSampleInFile),
+                            (size_t) numSamples * sizeof (float));
+
+            return true;
+        }
+
+    private:
+        const AudioBuffer<float>& buffer;
+    };
+
+    class BufferWriter  : public AudioFormatWriter
+    {
+    public:
+        BufferWriter (AudioBuffer<float>& dest, double rate)
+            : AudioFormatWriter (nullptr, "buffer", rate, (unsigned int) dest.getNumChannels(), 32), buffer (dest)
+        {
+            usesFloatingPointData = true;
+        }
+
+        bool write (const int** data, int numSamples) override
+        {
+            if (position + numSamples > buffer.getNumSamples())
+                return false;
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                memcpy (buffer.getWritePointer (ch, position), data[ch], (size_t) numSamples * sizeof (float));
+
+            position += numSamples;
+            return true;
+        }
+
+    private:
+        AudioBuffer<float>& buffer;
+        int position = 0;
+    };
+
+    bool sameBits (const AudioBuffer<float>& a, const AudioBuffer<float>& b)
+    {
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            if (memcmp (a.getReadPointer (ch), b.getReadPointer (ch), (size_t) a.getNumSamples() * sizeof (float)) != 0)
+                return false;
+
+        return true;
+    }
+
+    int checkSeams (const String& filter, int numWorkers)
+    {
+        AudioBuffer<float> input (2, seamLength), serial (2, seamLength), segmented (2, seamLength);
+        Random random (0x5048415a);
+
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < seamLength; ++i)
+                input.setSample (ch, i, 0.5f * (random.nextFloat() - 0.5f));
+
+        int numTests = 0, numFailed = 0;
+
+        for (int type = Oscillators::Sine; type <= Oscillators::Lorenz; ++type)
+            for (int stages : { 4, 12 })
+                for (int oversampling : { 0, 2 })
+                {
+                    const String name ("seams-" + String (oscillatorNames[type - 1]) + "-" + String (stages)
+                                         + "-x" + String (1 << oversampling));
+
+                    if (! name.contains (filter))
+                        continue;
+
+                    PhazerParameters params;
+                    params.rate = 2.0f;
+                    params.depth = 0.8f;
+                    params.width = 0.5f;
+                    params.centerfreq = 1000.0f;
+                    params.mix = 0.5f;
+                    params.stages = stages;
+                    params.oversampling = oversampling;
+
+                    auto setup = [type] (PhazerEngine& e)    { e.oscillator.setType (type); };
+
+                    // Serially, over the silence that flushes out the latency, which
+                    // is then dropped from the start like SegmentedRender does
+                    {
+                        PhazerEngine engine;
+                        engine.prepare (seamSampleRate, seamBlockSize);
+                        engine.setOversampling (oversampling);
+                        engine.reset();
+                        setup (engine);
+
+                        const int latency = engine.getLatencySamples();
+                        const int length = seamLength + latency;
+                        AudioBuffer<float> padded (2, length);
+                        padded.clear();
+
+                        for (int ch = 0; ch < 2; ++ch)
+                            padded.copyFrom (ch, 0, input, ch, 0, seamLength);
+
+                        for (int pos = 0; pos < length; pos += seamBlockSize)
+                        {
+                            AudioBuffer<float> block (padded.getArrayOfWritePointers(), 2, pos, jmin (seamBlockSize, length - pos));
+                            engine.process (block, params);
+                        }
+
+                        for (int ch = 0; ch < 2; ++ch)
+                            serial.copyFrom (ch, 0, padded, ch, latency, seamLength);
+
+                        engine.release();
+                    }
+
+                    SegmentedRender::Options options;
+                    options.numSegments = seamSegments;
+                    options.numThreads = jmin (seamSegments, numWorkers);
+                    options.blockSize = seamBlockSize;
+                    options.prerollSeconds = seamPrerollSeconds;
+
+                    SegmentedRender render ([&input] { return new BufferReader (input, seamSampleRate); }, params, setup, options);
+                    BufferWriter writer (segmented, seamSampleRate);
+                    const String error (render.run (writer));
+                    StringArray problems;
+
+                    if (error.isNotEmpty())
+                        problems.add (error);
+                    else if (! sameBits (serial, segmented))
+                        problems.add ("output differs from the serial render");
+
+                    if (render.getNumRepaired() > 0)
+                        problems.add (String (render.getNumRepaired()) + " of " + String (seamSegments - 1)
+                                        + " seams didn't settle in the pre-roll");
+
+                    ++numTests;
+
+                    if (problems.isEmpty())
+                        continue;
+
+                    ++numFailed;
+                    printf ("FAIL %s: %s\n", name.toRawUTF8(), problems.joinIntoString ("; ").toRawUTF8());
+                }
+
+        printf ("%d seam tests, %d failed\n", numTests, numFailed);
+        return numFailed > 0 ? 1 : 0;
+    }
+
+    int printUsage()
+    {
+        printf ("usage: phazer-regress [--corpus file] [--record] [--seams] [--filter text] [--dump dir] [--jobs n]\n");
+        return 1;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    File corpusFile (File::getCurrentWorkingDirectory().getChildFile ("Tools/Golden/corpus.txt"));
+    File dumpDirectory;
+    String filter;
+    bool recording = false, checkingSeams = false;
+    int numWorkers = SystemStats::getNumCpus();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+
+        if (arg == "--record")
+        {
+            recording = true;
+            continue;
+        }
+
+        if (arg == "--seams")
+        {
+            checkingSeams = true;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+            return printUsage();
+
+        const String value (argv[++i]);
+
+        if      (arg == "--corpus") corpusFile = File::getCurrentWorkingDirectory().getChildFile (value);
+        else if (arg == "--dump")   dumpDirectory = File::getCurrentWorkingDirectory().getChildFile (value);
+        else if (arg == "--filter") filter = value;
+        else if (arg == "--jobs")   numWorkers = jmax (1, value.getIntValue());
+        else                        return printUsage();
+    }
+
+    if (checkingSeams)
+        return checkSeams (filter, numWorkers);
+
+    Array<TestCase> tests;
+
+    auto addTest = [&] (const TestCase& test)
+    {
+        if (recording || test.getName().contains (filter))
+            tests.add (test);
+    };
+
+    for (int type = Oscillators::Sine; type <= Oscillators::Lorenz; ++type)
+    {
+        for (int stages = 1; stages <= 16; ++stages)
+            for (auto sampleRate : sampleRates)
+                for (int signal = 0; signal < numSignals; ++signal)
+                    addTest ({ type, stages, signal, sampleRate });
+
+        for (int stages : { 1, 4, 16 })
+            for (int signal = 0; signal < numSignals; ++signal)
+            {
+                for (int oversampling = 1; oversampling <= 2; ++oversampling)
+                    for (double sampleRate : { 44100.0, 48000.0 })
+                        addTest ({ type, stages, signal, sampleRate, oversampling });
+
+                for (float lfoRate : { defaultLfoRate, 20.0f })
+                    addTest ({ type, stages, signal, 48000.0, 0, true, lfoRate });
+            }
+    }
+
+    const int64 startTicks = Time::getHighResolutionTicks();
+
+    OwnedArray<TestResult> results;
+    runTests (tests, results, numWorkers, dumpDirectory != File());
+
+    const double seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - startTicks);
+    printf ("rendered %d tests in %.2f s\n", tests.size(), seconds);
+
+    if (recording)
+        return record (corpusFile, tests, results);
+
+    return check (corpusFile, tests, results, dumpDirectory);
+}
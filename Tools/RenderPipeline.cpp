@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+    RenderPipeline.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "RenderPipeline.h"
+
+class RenderPipeline::StageThread  : public Thread
+{
+public:
+    StageThread (const String& name, std::function<void()> stageFunction)
+        : Thread (name), stage (stageFunction)
+    {
+    }
+
+    void run() override
+    {
+        stage();
+    }
+
+private:
+    std::function<void()> stage;
+};
+
+//==============================================================================
+RenderPipeline::ChunkQueue::ChunkQueue (int capacity)
+    : fifo (capacity + 1),      // an AbstractFifo holds one less than its size
+      slots ((size_t) capacity + 1)
+{
+}
+
+void RenderPipeline::ChunkQueue::clear()
+{
+    fifo.reset();
+    ready.reset();
+}
+
+void RenderPipeline::ChunkQueue::push (int chunk)
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+    jassert (size1 + size2 == 1);   // there are never more chunks than slots
+
+    slots[size1 > 0 ? start1 : start2] = chunk;
+    fifo.finishedWrite (1);
+    ready.signal();
+}
+
+int RenderPipeline::ChunkQueue::pop (const std::atomic<bool>& aborted)
+{
+    while (fifo.getNumReady() == 0)
+    {
+        if (aborted.load())
+            return -1;
+
+        ready.wait (20);
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (1, start1, size1, start2, size2);
+
+    const int chunk = slots[size1 > 0 ? start1 : start2];
+    fifo.finishedRead (1);
+    return chunk;
+}
+
+//==============================================================================
+RenderPipeline::RenderPipeline (int maxChannels, int size, int numChunks)
+    : blockSize (size),
+      freeChunks (numChunks),
+      filledChunks (numChunks),
+      processedChunks (numChunks)
+{
+    for (int i = 0; i < numChunks; ++i)
+        chunks.add (new Chunk())->buffer.setSize (maxChannels, blockSize);
+}
+
+RenderPipeline::~RenderPipeline()
+{
+}
+
+String RenderPipeline::run (AudioFormatReader& reader, AudioFormatWriter& writer, const ProcessCallback& process,
+                           int latencySamples)
+{
+    const int numChannels = (int) reader.numChannels;
+    jassert (numChannels <= chunks[0]->buffer.getNumChannels());
+
+    latency = jmax (0, latencySamples);
+    aborted = false;
+    error.clear();
+
+    freeChunks.clear();
+    filledChunks.clear();
+    processedChunks.clear();
+
+    for (int i = 0; i < chunks.size(); ++i)
+        freeChunks.push (i);
+
+    StageThread readerThread ("Phazer render reader", [&] { readerStage (reader, numChannels); });
+    StageThread writerThread ("Phazer render writer", [&] { writerStage (writer, numChannels); });
+
+    readerThread.startThread();
+    writerThread.startThread();
+
+    for (;;)
+    {
+        const int index = filledChunks.pop (aborted);
+
+        if (index < 0)
+            break;
+
+        Chunk& chunk = *chunks[index];
+        const bool endOfFile = chunk.numSamples == 0;
+
+        if (! endOfFile)
+        {
+            AudioBuffer<float> block (chunk.buffer.getArrayOfWritePointers(), numChannels, chunk.numSamples);
+            process (block, chunk.position);
+        }
+
+        processedChunks.push (index);
+
+        if (endOfFile)
+            break;
+    }
+
+    readerThread.waitForThreadToExit (-1);
+    writerThread.waitForThreadToExit (-1);
+
+    return error;
+}
+
+void RenderPipeline::readerStage (AudioFormatReader& reader, int numChannels)
+{
+    // The input, then the silence that flushes out the latency
+    const int64 length = reader.lengthInSamples + latency;
+
+    for (int64 pos = 0;; pos += blockSize)
+    {
+        const int index = freeChunks.pop (aborted);
+
+        if (index < 0)
+            return;
+
+        Chunk& chunk = *chunks[index];
+        const int numSamples = (int) jlimit ((int64) 0, (int64) blockSize, length - pos);
+        const int numFromFile = (int) jlimit ((int64) 0, (int64) numSamples, reader.lengthInSamples - pos);
+
+        chunk.position = pos;
+        chunk.numSamples = numSamples;
+
+        if (numSamples > 0)
+        {
+            AudioBuffer<float> block (chunk.buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+            if (numFromFile > 0)
+                reader.read (&block, 0, numFromFile, pos, true, true);
+
+            block.clear (numFromFile, numSamples - numFromFile);
+        }
+
+        filledChunks.push (index);
+
+        if (numSamples == 0)
+            return;
+    }
+}
+
+void RenderPipeline::writerStage (AudioFormatWriter& writer, int numChannels)
+{
+    for (;;)
+    {
+        const int index = processedChunks.pop (aborted);
+
+        if (index < 0)
+            return;
+
+        Chunk& chunk = *chunks[index];
+
+        if (chunk.numSamples == 0)
+            return;
+
+        const AudioBuffer<float> block (chunk.buffer.getArrayOfWritePointers(), numChannels, chunk.numSamples);
+
+        // Whatever the latency delayed past the start is dropped
+        const int skip = (int) jlimit ((int64) 0, (int64) chunk.numSamples, latency - chunk.position);
+
+        if (skip < chunk.numSamples && ! writer.writeFromAudioSampleBuffer (block, skip, chunk.numSamples - skip))
+        {
+            abort ("write failed at sample " + String (chunk.position));
+            return;
+        }
+
+        freeChunks.push (index);
+    }
+}
+
+void RenderPipeline::abort (const String& message)
+{
+    {
+        const ScopedLock sl (errorLock);
+
+        if (error.isEmpty())
+            error = message;
+    }
+
+    aborted = true;
+}
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    RenderPipeline.h
+    Author:  eric carmi
+
+    Three stage offline rendering: a reader thread fills chunks from the
+    input, the calling thread processes them, and a writer thread writes them
+    out, so disk access and sample format conversion overlap with the DSP.
+
+    Chunks come from a fixed pool allocated up front. Only chunk indices move
+    between the stages, through single producer, single consumer queues:
+
+        free -> reader -> filled -> process -> processed -> writer -> free
+
+    The audio itself is never copied between stages.
+
+  ==============================================================================
+*/
+
+#ifndef RENDERPIPELINE_H_INCLUDED
+#define RENDERPIPELINE_H_INCLUDED
+
+#include "../Source/DspHeader.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <functional>
+
+class RenderPipeline
+{
+public:
+    RenderPipeline (int maxChannels, int blockSize, int numChunks = 4);
+    ~RenderPipeline();
+
+    int getBlockSize() const        { return blockSize; }
+
+    // Called on the thread that calls run(), once per chunk, in file order
+    typedef std::function<void (AudioBuffer<float>& block, int64 position)> ProcessCallback;
+
+    // Streams the whole reader through the callback into the writer.
+    // Returns an error message, or an empty string on success.
+    //
+    // For a process that delays its output, latencySamples of silence are
+    // run through it after the end of the input and as many samples are
+    // dropped from the start of the output, so the output lines up with the
+    // input and has the same length.
+    String run (AudioFormatReader& reader, AudioFormatWriter& writer, const ProcessCallback& process,
+                int latencySamples = 0);
+
+private:
+    struct Chunk
+    {
+        AudioBuffer<float> buffer;
+        int64 position = 0;
+        int numSamples = 0;         // 0 marks the end of the file
+    };
+
+    class ChunkQueue
+    {
+    public:
+        explicit ChunkQueue (int capacity);
+
+        // Only while no stage is running
+        void clear();
+
+        void push (int chunk);
+
+        // Waits for a chunk, returns -1 if the pipeline was aborted meanwhile
+        int pop (const std::atomic<bool>& aborted);
+
+    private:
+        AbstractFifo fifo;
+        HeapBlock<int> slots;
+        WaitableEvent ready;
+    };
+
+    class StageThread;
+
+    void readerStage (AudioFormatReader& reader, int numChannels);
+    void writerStage (AudioFormatWriter& writer, int numChannels);
+    void abort (const String& message);
+
+    const int blockSize;
+    int latency = 0;
+    OwnedArray<Chunk> chunks;
+    ChunkQueue freeChunks, filledChunks, processedChunks;
+
+    std::atomic<bool> aborted { false };
+    CriticalSection errorLock;
+    String error;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderPipeline)
+};
+
+#endif  // RENDERPIPELINE_H_INCLUDED
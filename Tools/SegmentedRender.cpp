@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    SegmentedRender.cpp
+    Author:  eric carmi
+
+  ==============================================================================
+*/
+
+#include "SegmentedRender.h"
+#include "WorkStealingScheduler.h"
+
+struct SegmentedRender::Segment
+{
+    int64 warmupStart, start, end;
+
+    PhazerEngine::State checkpoint;     // at warmupStart, from the pre-pass
+    PhazerEngine::State startState;     // at start, after the pre-roll
+    PhazerEngine::State endState;
+
+    // Planar float blocks: each block is all of channel 0, then all of channel 1
+    TemporaryFile output { ".raw" };
+    String error;
+};
+
+//==============================================================================
+class SegmentedRender::Worker  : public Thread
+{
+public:
+    Worker (SegmentedRender& r, WorkStealingScheduler& s, int workerIndex)
+        : Thread ("Phazer segment worker " + String (workerIndex)),
+          owner (r), scheduler (s), index (workerIndex)
+    {
+    }
+
+    void run() override
+    {
+        ScopedNoDenormals noDenormals;
+        ScopedPointer<AudioFormatReader> reader (owner.createReader());
+        PhazerEngine engine;
+        AudioBuffer<float> buffer (owner.numChannels, owner.options.blockSize);
+        int next;
+
+        owner.prepareEngine (engine);
+
+        while ((next = scheduler.next (index)) >= 0)
+        {
+            Segment& segment = *owner.segments[next];
+
+            if (reader == nullptr)
+                segment.error = "can't open the input";
+            else
+                segment.error = owner.renderSegment (segment, *reader, engine, buffer, segment.checkpoint, segment.warmupStart);
+        }
+
+        engine.release();
+    }
+
+private:
+    SegmentedRender& owner;
+    WorkStealingScheduler& scheduler;
+    const int index;
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+SegmentedRender::SegmentedRender (const ReaderFactory& readerFactory, const PhazerParameters& p,
+                                  const EngineSetup& setup, const Options& o)
+    : createReader (readerFactory), params (p), setupEngine (setup), options (o)
+{
+}
+
+SegmentedRender::~SegmentedRender()
+{
+}
+
+void SegmentedRender::prepareEngine (PhazerEngine& engine) const
+{
+    engine.prepare (sampleRate, options.blockSize);
+    engine.setOversampling (params.oversampling);      // so every checkpoint is taken at the same factor
+    engine.reset();
+    setupEngine (engine);
+}
+
+String SegmentedRender::run (AudioFormatWriter& writer)
+{
+    ScopedPointer<AudioFormatReader> reader (createReader());
+
+    if (reader == nullptr)
+        return "can't open the input";
+
+    sampleRate = reader->sampleRate;
+    numChannels = (int) reader->numChannels;
+
+    // Takes the checkpoints below, and knows the latency
+    PhazerEngine prepass;
+    prepareEngine (prepass);
+    latency = prepass.getLatencySamples();
+
+    // Segments and pre-rolls start on block boundaries, so every engine sees the
+    // same block sequence as a serial render would. The segments cover the
+    // silence that flushes out the latency too.
+    const int blockSize = options.blockSize;
+    const int64 length = reader->lengthInSamples + latency;
+    const int64 numBlocks = (length + blockSize - 1) / blockSize;
+    const int64 blocksPerSegment = jmax ((int64) 1, (numBlocks + options.numSegments - 1) / jmax (1, options.numSegments));
+    const int64 prerollBlocks = (int64) std::ceil (options.prerollSeconds * sampleRate / blockSize);
+
+    segments.clear();
+    numRepaired = 0;
+
+    for (int64 block = 0; block < jmax ((int64) 1, numBlocks); block += blocksPerSegment)
+    {
+        auto* s = segments.add (new Segment());
+        s->start = block * blockSize;
+        s->end = jmin (length, (block + blocksPerSegment) * blockSize);
+        s->warmupStart = jmax ((int64) 0, block - prerollBlocks) * blockSize;
+    }
+
+    // LFO-only pre-pass to find the checkpoints
+    {
+        int next = 0;
+
+        for (int64 pos = 0; next < segments.size(); pos += blockSize)
+        {
+            while (next < segments.size() && segments[next]->warmupStart == pos)
+                prepass.getState (segments[next++]->checkpoint);
+
+            prepass.skip ((int) jmin ((int64) blockSize, length - pos), params);
+        }
+
+        prepass.release();
+    }
+
+    // Render all segments in parallel, each from its own checkpoint
+    {
+        Array<int> order;
+        for (int i = 0; i < segments.size(); ++i)
+            order.add (i);
+
+        const int numThreads = jlimit (1, segments.size(), options.numThreads);
+        WorkStealingScheduler scheduler (numThreads, order);
+
+        OwnedArray<Worker> workers;
+        for (int i = 0; i < numThreads; ++i)
+            workers.add (new Worker (*this, scheduler, i))->startThread();
+
+        for (auto* w : workers)
+            w->waitForThreadToExit (-1);
+    }
+
+    for (auto* s : segments)
+        if (s->error.isNotEmpty())
+            return s->error;
+
+    // Check the seams, and redo any segment whose filters hadn't settled
+    PhazerEngine engine;
+    AudioBuffer<float> buffer (numChannels, blockSize);
+    prepareEngine (engine);
+
+    for (int i = 1; i < segments.size(); ++i)
+    {
+        const Segment& previous = *segments[i - 1];
+        Segment& segment = *segments[i];
+
+        if (! sameState (segment.startState, previous.endState))
+        {
+            const String error (renderSegment (segment, *reader, engine, buffer, previous.endState, segment.start));
+
+            if (error.isNotEmpty())
+                return error;
+
+            ++numRepaired;
+        }
+    }
+
+    // Join the segments into the output, less whatever the latency delayed past the start
+    for (auto* s : segments)
+    {
+        FileInputStream input (s->output.getFile());
+
+        if (input.failedToOpen())
+            return "can't read back " + s->output.getFile().getFullPathName();
+
+        for (int64 pos = s->start; pos < s->end; pos += blockSize)
+        {
+            const int numSamples = (int) jmin ((int64) blockSize, s->end - pos);
+            const int skip = (int) jlimit ((int64) 0, (int64) numSamples, latency - pos);
+
+            for (int chan = 0; chan < numChannels; ++chan)
+                if (input.read (buffer.getWritePointer (chan), numSamples * (int) sizeof (float)) != numSamples * (int) sizeof (float))
+                    return "segment file is short: " + s->output.getFile().getFullPathName();
+
+            if (skip < numSamples && ! writer.writeFromAudioSampleBuffer (buffer, skip, numSamples - skip))
+                return "write failed at sample " + String (pos - latency);
+        }
+    }
+
+    return {};
+}
+
+String SegmentedRender::renderSegment (Segment& segment, AudioFormatReader& reader, PhazerEngine& engine,
+                                       AudioBuffer<float>& buffer, const PhazerEngine::State& from, int64 fromPosition) const
+{
+    const File file (segment.output.getFile());
+    file.deleteFile();
+
+    FileOutputStream output (file, 1 << 20);
+
+    if (output.failedToOpen())
+        return "can't write " + file.getFullPathName();
+
+    engine.setState (from);
+
+    for (int64 pos = fromPosition; pos < segment.end; pos += options.blockSize)
+    {
+        const int numSamples = (int) jmin ((int64) options.blockSize, segment.end - pos);
+        AudioBuffer<float> block (buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+        if (pos == segment.start)
+            engine.getState (segment.startState);
+
+        readInput (reader, block, pos);
+        engine.process (block, params);
+
+        if (pos >= segment.start)
+            for (int chan = 0; chan < numChannels; ++chan)
+                if (! output.write (block.getReadPointer (chan), (size_t) numSamples * sizeof (float)))
+                    return "can't write " + file.getFullPathName();
+    }
+
+    if (segment.start == segment.end)       // an empty file
+        engine.getState (segment.startState);
+
+    engine.getState (segment.endState);
+    output.flush();
+
+    return {};
+}
+
+// Silence past the end of the file
+void SegmentedRender::readInput (AudioFormatReader& reader, AudioBuffer<float>& block, int64 position)
+{
+    const int numSamples = block.getNumSamples();
+    const int numFromFile = (int) jlimit ((int64) 0, (int64) numSamples, reader.lengthInSamples - position);
+
+    if (numFromFile > 0)
+        reader.read (&block, 0, numFromFile, position, true, true);
+
+    block.clear (numFromFile, numSamples - numFromFile);
+}
+
+// Compares everything the output depends on, bit for bit
+bool SegmentedRender::sameState (const PhazerEngine::State& a, const PhazerEngine::State& b)
+{
+    const Oscillators::State& oa = a.oscillator;
+    const Oscillators::State& ob = b.oscillator;
+
+    // Field by field where the structs have padding in them
+    return sameBits (oa.delay1, ob.delay1) && sameBits (oa.delay2, ob.delay2) && sameBits (oa.delay3, ob.delay3)
+        && sameBits (oa.oscCounter, ob.oscCounter)
+        && oa.currentOscillatorType == ob.currentOscillatorType
+        && sameBits (oa.oscParam1, ob.oscParam1) && sameBits (oa.oscParam2, ob.oscParam2) && sameBits (oa.oscParam3, ob.oscParam3)
+        && sameBits (oa.oscFreq, ob.oscFreq) && sameBits (oa.sampleRate, ob.sampleRate) && sameBits (oa.sampleTime, ob.sampleTime)
+        && sameBits (oa.duffing1, ob.duffing1)
+        && oa.delta == ob.delta && oa.delta2 == ob.delta2
+        && sameBits (a.filterLeft, b.filterLeft) && sameBits (a.filterRight, b.filterRight)
+        && sameSmoother (a.depth, b.depth) && sameSmoother (a.rate, b.rate)
+        && sameSmoother (a.width, b.width) && sameSmoother (a.centerfreq, b.centerfreq)
+        && sameSmoother (a.mix, b.mix) && sameSmoother (a.numstages, b.numstages)
+        && sameBits (a.osc, b.osc) && sameBits (a.ICs, b.ICs)
+        && sameBits (a.LFOangle, b.LFOangle) && sameBits (a.sampleRate, b.sampleRate)
+        && a.crossFadeFlag == b.crossFadeFlag && a.resetICflag == b.resetICflag
+        && sameBits (a.oversampler, b.oversampler);
+}
+
+// The smoother's fields are private, so this runs copies of both to the end of
+// their ramps, which shows up any difference in value, target, step or steps
+// left, then through one more ramp to compare the ramp lengths.
+bool SegmentedRender::sameSmoother (LinearSmoothedValue<double> a, LinearSmoothedValue<double> b)
+{
+    for (int ramp = 0; ramp < 2; ++ramp)
+    {
+        for (;;)
+        {
+            if (! sameBits (a.getCurrentValue(), b.getCurrentValue())
+                 || ! sameBits (a.getTargetValue(), b.getTargetValue())
+                 || a.isSmoothing() != b.isSmoothing())
+                return false;
+
+            if (! a.isSmoothing())
+                break;
+
+            a.getNextValue();
+            b.getNextValue();
+        }
+
+        a.setTargetValue (a.getTargetValue() + 1.0);
+        b.setTargetValue (b.getTargetValue() + 1.0);
+    }
+
+    return true;
+}
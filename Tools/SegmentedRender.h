@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    SegmentedRender.h
+    Author:  eric carmi
+
+    Renders one long file on several cores by splitting it into segments.
+
+    A segment can't just start from a fresh engine: the LFO, the smoothers and
+    the allpass state all carry over from everything before it. The LFO and
+    smoothers don't depend on the audio, so a quick pre-pass with
+    PhazerEngine::skip() finds their state at every segment. Each segment then
+    starts from that checkpoint a little early (the pre-roll) to let the filter
+    state settle, and renders its part into a temporary file.
+
+    The filters usually settle to exactly the state a serial render would have,
+    but that isn't guaranteed, so when all segments are done each one's start
+    state is compared with the end state of the one before. Any segment that
+    doesn't match is rendered again from that end state. The result is always
+    bit-identical to rendering the file in one go. phazer-regress --seams
+    checks that typical settings never need that.
+
+    With oversampling the engine delays its output, so like RenderPipeline the
+    render runs on over that much silence past the end of the input and drops
+    as much from the start of the output.
+
+  ==============================================================================
+*/
+
+#ifndef SEGMENTEDRENDER_H_INCLUDED
+#define SEGMENTEDRENDER_H_INCLUDED
+
+#include "../Source/PhazerEngine.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <functional>
+
+class SegmentedRender
+{
+public:
+    struct Options
+    {
+        int numSegments = 1;
+        int numThreads = 1;
+        int blockSize = 65536;
+        double prerollSeconds = 1.0;
+    };
+
+    // Every segment worker needs its own reader of the input
+    typedef std::function<AudioFormatReader*()> ReaderFactory;
+
+    // Called on each engine after prepare() and reset(), to set the oscillator and ICs
+    typedef std::function<void (PhazerEngine&)> EngineSetup;
+
+    SegmentedRender (const ReaderFactory& createReader, const PhazerParameters& params,
+                     const EngineSetup& setupEngine, const Options& options);
+    ~SegmentedRender();
+
+    // Returns an error message, or an empty string on success
+    String run (AudioFormatWriter& writer);
+
+    // How many segments had to be rendered again after the parallel pass
+    int getNumRepaired() const          { return numRepaired; }
+
+private:
+    struct Segment;
+    class Worker;
+
+    void prepareEngine (PhazerEngine& engine) const;
+    String renderSegment (Segment& segment, AudioFormatReader& reader, PhazerEngine& engine,
+                          AudioBuffer<float>& buffer, const PhazerEngine::State& from, int64 fromPosition) const;
+    static void readInput (AudioFormatReader& reader, AudioBuffer<float>& block, int64 position);
+    static bool sameState (const PhazerEngine::State& a, const PhazerEngine::State& b);
+    static bool sameSmoother (LinearSmoothedValue<double> a, LinearSmoothedValue<double> b);
+
+    template <typename Type>
+    static bool sameBits (const Type& a, const Type& b)     { return memcmp (&a, &b, sizeof (Type)) == 0; }
+
+    ReaderFactory createReader;
+    PhazerParameters params;
+    EngineSetup setupEngine;
+    Options options;
+
+    double sampleRate = 0.0;
+    int numChannels = 0;
+    int latency = 0;
+    OwnedArray<Segment> segments;
+    int numRepaired = 0;
+
+    JUCE_DECLARE_NON_COPYABLE (SegmentedRender)
+};
+
+#endif  // SEGMENTEDRENDER_H_INCLUDED
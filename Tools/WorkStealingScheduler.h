@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    WorkStealingScheduler.h
+    Author:  eric carmi
+
+    Hands out job indices to a fixed set of workers.
+
+    Every worker has its own queue. Jobs are dealt out round robin up front,
+    a worker takes from the front of its own queue and, once that is empty,
+    steals from the back of the others. Jobs here are whole files, so a lock
+    per queue costs nothing next to the work, and a worker that drew short
+    files keeps helping out until everything is taken.
+
+  ==============================================================================
+*/
+
+#ifndef WORKSTEALINGSCHEDULER_H_INCLUDED
+#define WORKSTEALINGSCHEDULER_H_INCLUDED
+
+class WorkStealingScheduler
+{
+public:
+    // Jobs should be sorted by expected cost, largest first, so the long
+    // ones start early and the short ones fill the gaps at the end
+    WorkStealingScheduler (int numWorkers, const Array<int>& jobs)
+    {
+        for (int i = 0; i < numWorkers; ++i)
+            queues.add (new Queue());
+
+        for (int i = 0; i < jobs.size(); ++i)
+            queues[i % numWorkers]->jobs.add (jobs[i]);
+
+        for (auto* q : queues)
+            q->tail = q->jobs.size();
+    }
+
+    // Returns the next job for a worker, or -1 once every job has been taken
+    int next (int worker)
+    {
+        {
+            Queue& own = *queues[worker];
+            const SpinLock::ScopedLockType lock (own.lock);
+
+            if (own.head < own.tail)
+                return own.jobs[own.head++];
+        }
+
+        for (int i = 1; i < queues.size(); ++i)
+        {
+            Queue& victim = *queues[(worker + i) % queues.size()];
+            const SpinLock::ScopedLockType lock (victim.lock);
+
+            if (victim.head < victim.tail)
+                return victim.jobs[--victim.tail];
+        }
+
+        return -1;
+    }
+
+private:
+    struct Queue
+    {
+        SpinLock lock;
+        Array<int> jobs;
+        int head = 0, tail = 0;     // jobs [head, tail) are still waiting
+    };
+
+    OwnedArray<Queue> queues;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkStealingScheduler)
+};
+
+#endif  // WORKSTEALINGSCHEDULER_H_INCLUDED